@@ -46,7 +46,7 @@ void Cilp::computeParams(std::set<logic::ClausePtr>& clauses, double& amin, doub
   // Compute the A_min value, i.e. the minimal value where a unit is consider to
   // evaluate to true
   // the nan check is for some networks that use compute its own amin.
-  amin = amin != NAN
+  amin = !std::isnan(amin)
              ? amin
              : ((double)maxksmus - 1.0) / ((double)maxksmus + 1.0) + 0.000001;
   // computes the w, which is the standar weight for the units.
@@ -85,9 +85,11 @@ neural::NeuralNetworkPtr Cilp::buildNetwork(logic::ProgramPtr pr) {
 }
 
 neural::NeuralNetworkPtr Cilp::buildNetwork(std::set<logic::ClausePtr> cls) {
-  // we compute the parameters.
+  // we compute the parameters of this program, the member amin is only used
+  // when the caller set it, so building another program computes its own
   std::map<std::string, int> mus;
-  computeParams(cls, amin, w, beta, mus);
+  double unitAmin = amin, unitW;
+  computeParams(cls, unitAmin, unitW, beta, mus);
 
   std::shared_ptr<neural::FeedForwardNeuralNetwork> res(new neural::FeedForwardNeuralNetwork);
 
@@ -110,9 +112,13 @@ neural::NeuralNetworkPtr Cilp::buildNetwork(std::set<logic::ClausePtr> cls) {
 
     str = **it;
     str += "_o";
-    neural::NeuralNodePtr output(new neural::NeuralNode(str, linear));
+    neural::NeuralNodePtr output(new neural::NeuralNode(str, bipolar));
     output->setType(neural::OUTPUT);
-    output->setLayer(0);
+    output->setLayer(2);
+    // the bias is minus the threshold of the unit, the nodes add it to their
+    // weighted sum
+    int mu = mus.find(**it) == mus.end() ? 0 : mus[**it];
+    output->setBias(-((1 + unitAmin) * (1 - mu) * unitW) / 2);
 
     res->addNode(output, 0);
   }
@@ -126,9 +132,10 @@ neural::NeuralNetworkPtr Cilp::buildNetwork(std::set<logic::ClausePtr> cls) {
 
     neural::NeuralNodePtr hidden(new neural::NeuralNode(name.str(), bipolar));
     hidden->setLayer(1);
-    hidden->setBias(((1 + amin) * (k - 1) * w) / 2);
+    hidden->setBias(-((1 + unitAmin) * (k - 1) * unitW) / 2);
 
     res->addNode(hidden);
+    counter++;
 
     // we connect the newly added node to the nodes that represent the other
     // literals in the clause.
@@ -136,9 +143,13 @@ neural::NeuralNetworkPtr Cilp::buildNetwork(std::set<logic::ClausePtr> cls) {
       std::string source = *(**litit).getVar();
       source += "_i";
       res->connectNodes(source, hidden->getId(),
-                        (*litit)->isNegated() ? -w : w);
-      counter++;
+                        (*litit)->isNegated() ? -unitW : unitW);
     }
+
+    // the unit of the head is the disjunction of the clauses defining it
+    std::string head = *(**it).getHead();
+    head += "_o";
+    res->connectNodes(hidden->getId(), head, unitW);
   }
 
   return res;
@@ -28,7 +28,7 @@ namespace algorithms {
 class Cilp : public NNBuilderAlgo {
  protected:
   double beta;
-  double amin, w;
+  double amin;
 
   /**
    * Compute the parameters needed by the CiLP algorithm.
@@ -66,8 +66,13 @@ class Cilp : public NNBuilderAlgo {
   static std::set<logic::BoolVarPtr> getAtoms(std::set<logic::ClausePtr>& cls);
 
  public:
-  Cilp(double _beta = 1, double _amin = NAN)
-      : beta(_beta), amin(_amin), w(NAN) {};
+  /**
+   * @param _beta The beta value of the activation function of the nodes.
+   *
+   * @param _amin The minimum value in which a neuron is said to evaluate to
+   * true, NAN to compute it from each program built.
+   */
+  Cilp(double _beta = 1, double _amin = NAN) : beta(_beta), amin(_amin) {};
   virtual ~Cilp();
 
   virtual neural::NeuralNetworkPtr buildNetwork(logic::ProgramPtr pr);
@@ -0,0 +1,551 @@
+/**
+ * @file compiled.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "compiled.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+
+#include "nalso/neural/kernels.hh"
+#include "nalso/neural/method.hh"
+
+namespace nalso {
+namespace neural {
+
+namespace {
+
+/** Number of values converted to double at a time by applyKernel */
+const unsigned int KERNEL_CHUNK = 64;
+
+/**
+ * Applies a kernel, which works over doubles, to values stored with type T.
+ * Single precision values are converted in small chunks that stay in cache.
+ */
+template <typename T, typename K>
+inline void applyKernel(T* values, unsigned int count, K kernel) {
+  if constexpr (std::is_same_v<T, double>) {
+    kernel(values, count);
+  } else {
+    double buffer[KERNEL_CHUNK];
+    for (unsigned int i = 0; i < count; i += KERNEL_CHUNK) {
+      unsigned int n = std::min(KERNEL_CHUNK, count - i);
+      std::copy_n(values + i, n, buffer);
+      kernel(buffer, n);
+      std::copy_n(buffer, n, values + i);
+    }
+  }
+}
+
+/**
+ * Finds out which activation kind is implemented by the given method.
+ *
+ * @return the activation kind or -1 if the method is unknown.
+ */
+int activationKind(NeuralMethod* method, double& beta) {
+  beta = 1;
+  if (dynamic_cast<LinearMethod*>(method)) return LINEAR_ACTIVATION;
+  if (dynamic_cast<SigmoidMethod*>(method)) return SIGMOID_ACTIVATION;
+  if (dynamic_cast<StepMethod*>(method)) return STEP_ACTIVATION;
+  BipolarSemilinearMethod* bipolar = dynamic_cast<BipolarSemilinearMethod*>(method);
+  if (bipolar) {
+    beta = bipolar->getBeta();
+    return BIPOLAR_ACTIVATION;
+  }
+  return -1;
+}
+
+}  // namespace
+
+std::shared_ptr<CompiledNetwork> CompiledNetwork::compile(
+    const std::vector<NeuralEndPtr>& inputs,
+    const std::vector<NeuralEndPtr>& outputs,
+    const std::vector<std::vector<NeuralNodePtr> >& nodes) {
+  // an output end adds all its inputs, the plan reads a single slot for it
+  for (unsigned int o = 0; o < outputs.size(); o++) {
+    if (outputs[o]->getNumInputs() > 1) return std::shared_ptr<CompiledNetwork>();
+  }
+
+  std::shared_ptr<CompiledNetwork> res(new CompiledNetwork);
+  std::unordered_map<NeuralConnection*, unsigned int> slots;
+
+  res->leaves = inputs;
+  res->numInputs = inputs.size();
+  for (unsigned int i = 0; i < inputs.size(); i++) {
+    slots[inputs[i].get()] = i;
+  }
+
+  // Depth first search from the outputs. A node is added to the order once
+  // all its inputs have been added, which is exactly the order in which the
+  // recursive evaluation finishes computing them.
+  enum { VISITING = 1, DONE = 2 };
+  std::unordered_map<NeuralConnection*, int> state;
+  std::vector<std::pair<NeuralConnectionPtr, unsigned int> > stack;
+  std::vector<NeuralNodePtr> order;
+
+  auto visit = [&](NeuralConnectionPtr conn) -> bool {
+    if ((conn->getType() & PURE_INPUT) == PURE_INPUT) {
+      // input ends that were not registered in the network are read as well
+      if (slots.find(conn.get()) == slots.end()) {
+        slots[conn.get()] = res->leaves.size();
+        res->leaves.push_back(std::static_pointer_cast<NeuralEnd>(conn));
+      }
+      return true;
+    }
+    int& st = state[conn.get()];
+    if (st == DONE) return true;
+    if (st == VISITING) return false;  // the graph has a cycle
+    if (!std::dynamic_pointer_cast<NeuralNode>(conn)) return false;
+    st = VISITING;
+    stack.push_back(std::make_pair(conn, 0));
+    return true;
+  };
+
+  for (unsigned int o = 0; o < outputs.size(); o++) {
+    for (unsigned int i = 0; i < outputs[o]->getNumInputs(); i++) {
+      if (!visit(outputs[o]->getInput(i))) return CompiledNetworkPtr();
+
+      while (!stack.empty()) {
+        NeuralConnectionPtr top = stack.back().first;
+        unsigned int next = stack.back().second;
+        if (next < top->getNumInputs()) {
+          stack.back().second++;
+          if (!visit(top->getInput(next))) return CompiledNetworkPtr();
+        } else {
+          state[top.get()] = DONE;
+          order.push_back(std::static_pointer_cast<NeuralNode>(top));
+          stack.pop_back();
+        }
+      }
+    }
+  }
+
+  // The activation of every node is resolved once, and its level is one more
+  // than the highest level of its inputs, so nodes of the same level never
+  // depend on each other.
+  std::unordered_map<NeuralNode*, int> kinds;
+  std::unordered_map<NeuralNode*, double> betas;
+  std::unordered_map<NeuralConnection*, unsigned int> levels;
+  for (unsigned int n = 0; n < order.size(); n++) {
+    NeuralNode& node = *order[n];
+    int kind = activationKind(node.getMethod().get(), betas[&node]);
+    if (kind < 0) return CompiledNetworkPtr();
+    kinds[&node] = kind;
+
+    unsigned int level = 0;
+    for (unsigned int i = 0; i < node.getNumInputs(); i++) {
+      auto it = levels.find(node.getInput(i).get());
+      if (it != levels.end()) level = std::max(level, it->second + 1);
+    }
+    levels[&node] = level;
+  }
+
+  // Nodes are grouped by subnetwork as long as that keeps them topologically
+  // sorted, i.e. when no connection crosses two subnetworks.
+  unsigned int noSubnets = std::max<unsigned int>(nodes.size(), 1);
+  bool crossed = false;
+  for (unsigned int n = 0; n < order.size(); n++) {
+    noSubnets = std::max<unsigned int>(noSubnets, order[n]->getSubnetwork() + 1);
+    for (unsigned int i = 0; i < order[n]->getNumInputs(); i++) {
+      NeuralConnectionPtr in = order[n]->getInput(i);
+      if ((in->getType() & PURE_INPUT) != PURE_INPUT &&
+          in->getSubnetwork() != order[n]->getSubnetwork()) {
+        crossed = true;
+      }
+    }
+  }
+  res->independent = !crossed;
+
+  // Inside each subnetwork the nodes are sorted by level and then by
+  // activation, which keeps them topologically sorted and puts the nodes that
+  // share an activation function next to each other.
+  auto key = [&](const NeuralNodePtr& node) {
+    return std::make_tuple(crossed ? 0 : node->getSubnetwork(),
+                           levels[node.get()], kinds[node.get()],
+                           betas[node.get()]);
+  };
+  std::stable_sort(order.begin(), order.end(),
+                   [&](const NeuralNodePtr& a, const NeuralNodePtr& b) {
+                     return key(a) < key(b);
+                   });
+
+  if (crossed) {
+    res->subnetStart.push_back(0);
+    res->subnetStart.push_back(order.size());
+  } else {
+    res->subnetStart.assign(noSubnets + 1, 0);
+    for (unsigned int n = 0; n < order.size(); n++) {
+      res->subnetStart[order[n]->getSubnetwork() + 1]++;
+    }
+    for (unsigned int s = 0; s < noSubnets; s++) {
+      res->subnetStart[s + 1] += res->subnetStart[s];
+    }
+  }
+
+  // A group is a maximal run of nodes with the same key, so a group never
+  // crosses two subnetworks.
+  for (unsigned int n = 0; n < order.size(); n++) {
+    if (n == 0 || key(order[n]) != key(order[n - 1])) {
+      res->groupStart.push_back(n);
+      res->groupKind.push_back(kinds[order[n].get()]);
+    }
+  }
+  res->groupStart.push_back(order.size());
+  for (unsigned int s = 0, g = 0; s < res->subnetStart.size(); s++) {
+    while (res->groupStart[g] < res->subnetStart[s]) g++;
+    res->subnetGroup.push_back(g);
+  }
+
+  unsigned int base = res->leaves.size();
+  for (unsigned int n = 0; n < order.size(); n++) {
+    slots[order[n].get()] = base + n;
+  }
+
+  // Now the nodes are written in CSR form, their weights go to the arena.
+  res->sources = order;
+  res->rowStart.push_back(0);
+  for (unsigned int n = 0; n < order.size(); n++) {
+    NeuralNode& node = *order[n];
+    res->kind.push_back(kinds[&node]);
+    res->beta.push_back(betas[&node]);
+    res->weightOffset.push_back(res->column.size() + n);
+
+    for (unsigned int i = 0; i < node.getNumInputs(); i++) {
+      res->column.push_back(slots[node.getInput(i).get()]);
+    }
+    res->rowStart.push_back(res->column.size());
+  }
+
+  const unsigned int LINE = 64 / sizeof(double);
+  unsigned int noWeights = res->column.size() + order.size();
+  res->sectionSize = (noWeights + LINE - 1) / LINE * LINE;
+  res->arena.assign(NO_SECTIONS * res->sectionSize, 0);
+  for (unsigned int n = 0; n < order.size(); n++) {
+    std::vector<double>& weights = order[n]->getWeights();
+    std::copy(weights.begin(), weights.end(),
+              res->section(WEIGHTS) + res->weightOffset[n]);
+    std::vector<double>& changes = order[n]->getChangeInWeights();
+    std::copy(changes.begin(), changes.end(),
+              res->section(CHANGE_IN_WEIGHTS) + res->weightOffset[n]);
+  }
+  res->saveWeights();
+
+  for (unsigned int o = 0; o < outputs.size(); o++) {
+    if (outputs[o]->getNumInputs() == 0) {
+      res->outputSource.push_back(-1);
+    } else {
+      res->outputSource.push_back(slots[outputs[o]->getInput(0).get()]);
+    }
+  }
+
+  res->values.assign(base + order.size(), 0);
+  return res;
+}
+
+unsigned int CompiledNetwork::addSections(unsigned int count) {
+  // look for a run of released sections long enough first
+  unsigned int run = 0;
+  for (unsigned int s = 0; s < releasedSections.size() && count; s++) {
+    run = releasedSections[s] ? run + 1 : 0;
+    if (run == count) {
+      unsigned int first = s + 1 - count;
+      std::fill_n(releasedSections.begin() + first, count, false);
+      std::fill_n(section(NO_SECTIONS + first), count * sectionSize, 0.0);
+      return NO_SECTIONS + first;
+    }
+  }
+
+  unsigned int first = noSections();
+  arena.resize(arena.size() + count * sectionSize, 0);
+  releasedSections.resize(releasedSections.size() + count, false);
+  return first;
+}
+
+void CompiledNetwork::releaseSections(unsigned int first, unsigned int count) {
+  for (unsigned int s = first; s < first + count; s++) {
+    if (s >= NO_SECTIONS && s - NO_SECTIONS < releasedSections.size()) {
+      releasedSections[s - NO_SECTIONS] = true;
+    }
+  }
+  while (!releasedSections.empty() && releasedSections.back()) {
+    releasedSections.pop_back();
+    arena.resize(arena.size() - sectionSize);
+  }
+}
+
+void CompiledNetwork::saveWeights() {
+  std::memcpy(section(BEST_WEIGHTS), section(WEIGHTS), sectionSize * sizeof(double));
+}
+
+void CompiledNetwork::restoreWeights() {
+  std::memcpy(section(WEIGHTS), section(BEST_WEIGHTS), sectionSize * sizeof(double));
+  weightsChanged();
+}
+
+void CompiledNetwork::writeBack() {
+  for (unsigned int n = 0; n < sources.size(); n++) {
+    std::vector<double>& weights = sources[n]->getWeights();
+    std::copy_n(section(WEIGHTS) + weightOffset[n], weights.size(), weights.begin());
+    std::vector<double>& changes = sources[n]->getChangeInWeights();
+    std::copy_n(section(CHANGE_IN_WEIGHTS) + weightOffset[n], changes.size(),
+                changes.begin());
+  }
+}
+
+void CompiledNetwork::evaluate() {
+  // input ends which were never set evaluate to zero
+  for (unsigned int i = 0; i < leaves.size(); i++) {
+    values[i] = leaves[i]->outputValue(true);
+  }
+  forward();
+}
+
+void CompiledNetwork::evaluate(std::span<const double> input,
+                               std::span<double> output) {
+  std::copy(input.begin(), input.begin() + numInputs, values.begin());
+  // input ends that are not ports of the network keep being read from the end
+  for (unsigned int i = numInputs; i < leaves.size(); i++) {
+    values[i] = leaves[i]->outputValue(true);
+  }
+  forward();
+
+  for (unsigned int o = 0; o < outputSource.size(); o++) {
+    output[o] = outputValue(o);
+  }
+}
+
+void CompiledNetwork::evaluateBatch(std::span<const double> input,
+                                    std::span<double> output,
+                                    unsigned int rows) {
+  switch (precision) {
+    case FLOAT_PRECISION:
+      syncFloatWeights();
+      evaluateTiles<float, float>(floatTile, input, output, rows);
+      break;
+    case MIXED_PRECISION:
+      syncFloatWeights();
+      evaluateTiles<float, double>(floatTile, input, output, rows);
+      break;
+    default:
+      evaluateTiles<double, double>(tile, input, output, rows);
+  }
+}
+
+void CompiledNetwork::setPrecision(Precision _precision) {
+  precision = _precision;
+  if (precision == DOUBLE_PRECISION) {
+    floatWeights = utils::AlignedVector<float>();
+    floatValues = utils::AlignedVector<float>();
+    floatTile = utils::AlignedVector<float>();
+  } else {
+    floatValues.resize(values.size());
+  }
+  floatStale = true;
+}
+
+void CompiledNetwork::syncFloatWeights() {
+  if (!floatStale) return;
+  floatWeights.resize(sectionSize);
+  std::copy_n(section(WEIGHTS), sectionSize, floatWeights.begin());
+  floatStale = false;
+}
+
+template <typename T, typename A>
+void CompiledNetwork::evaluateTiles(utils::AlignedVector<T>& buffer,
+                                    std::span<const double> input,
+                                    std::span<double> output,
+                                    unsigned int rows) {
+  unsigned int noOuts = outputSource.size();
+  buffer.resize(values.size() * BATCH_TILE);
+
+  for (unsigned int first = 0; first < rows; first += BATCH_TILE) {
+    unsigned int count = std::min(BATCH_TILE, rows - first);
+
+    // the inputs of the tile are transposed into slot major order
+    for (unsigned int i = 0; i < numInputs; i++) {
+      T* slot = buffer.data() + i * BATCH_TILE;
+      const double* row = input.data() + first * numInputs + i;
+      for (unsigned int j = 0; j < count; j++) {
+        slot[j] = row[j * numInputs];
+      }
+    }
+    for (unsigned int i = numInputs; i < leaves.size(); i++) {
+      std::fill_n(buffer.data() + i * BATCH_TILE, count,
+                  (T)leaves[i]->outputValue(true));
+    }
+
+    if (parallel()) {
+      pool->parallelFor(noSubNN(), [&](unsigned int s) {
+        forwardTile<T, A>(buffer.data(), count, subnetStart[s], subnetStart[s + 1]);
+      });
+    } else {
+      forwardTile<T, A>(buffer.data(), count, 0, kind.size());
+    }
+
+    for (unsigned int o = 0; o < noOuts; o++) {
+      double* row = output.data() + first * noOuts + o;
+      if (outputSource[o] < 0) {
+        for (unsigned int j = 0; j < count; j++) row[j * noOuts] = 0;
+      } else {
+        const T* slot = buffer.data() + outputSource[o] * BATCH_TILE;
+        for (unsigned int j = 0; j < count; j++) row[j * noOuts] = slot[j];
+      }
+    }
+  }
+}
+
+template <typename T, typename A>
+void CompiledNetwork::forwardTile(T* buffer, unsigned int count,
+                                  unsigned int first, unsigned int last) {
+  const T* weights = weightData<T>();
+  T* slot = buffer + (leaves.size() + first) * BATCH_TILE;
+  A sum[BATCH_TILE];
+  for (unsigned int n = first; n < last; n++, slot += BATCH_TILE) {
+    const T* block = weights + weightOffset[n];
+    // the sums always cover the whole tile, a fixed trip count is what lets
+    // the compiler vectorise the loop, the lanes past count are ignored
+    std::fill_n(sum, BATCH_TILE, kind[n] == STEP_ACTIVATION ? 0 : (A)block[0]);
+    for (unsigned int e = rowStart[n], k = 1; e < rowStart[n + 1]; e++, k++) {
+      const T* in = buffer + column[e] * BATCH_TILE;
+      A weight = block[k];
+      for (unsigned int j = 0; j < BATCH_TILE; j++) {
+        sum[j] += in[j] * weight;
+      }
+    }
+
+    switch (kind[n]) {
+      case STEP_ACTIVATION:
+        for (unsigned int j = 0; j < count; j++) slot[j] = sum[j] >= block[0] ? 1 : 0;
+        break;
+      case SIGMOID_ACTIVATION:
+        std::copy_n(sum, count, slot);
+        applyKernel(slot, count, [&](double* v, unsigned int c) {
+          kernels::sigmoid(v, c, accuracy);
+        });
+        break;
+      case BIPOLAR_ACTIVATION:
+        std::copy_n(sum, count, slot);
+        applyKernel(slot, count, [&](double* v, unsigned int c) {
+          kernels::bipolar(v, c, beta[n], accuracy);
+        });
+        break;
+      default:
+        std::copy_n(sum, count, slot);
+    }
+  }
+}
+
+void CompiledNetwork::forward() {
+  switch (precision) {
+    case FLOAT_PRECISION:
+      forwardFloat<float>();
+      break;
+    case MIXED_PRECISION:
+      forwardFloat<double>();
+      break;
+    default:
+      forwardSubnetworks<double, double>(values.data());
+  }
+}
+
+template <typename A>
+void CompiledNetwork::forwardFloat() {
+  syncFloatWeights();
+  std::copy_n(values.begin(), leaves.size(), floatValues.begin());
+  forwardSubnetworks<float, A>(floatValues.data());
+  // outputValue reads the values array
+  for (unsigned int o = 0; o < outputSource.size(); o++) {
+    if (outputSource[o] >= 0) values[outputSource[o]] = floatValues[outputSource[o]];
+  }
+}
+
+template <typename T, typename A>
+void CompiledNetwork::forwardSubnetworks(T* slots) {
+  if (parallel()) {
+    pool->parallelFor(noSubNN(), [&](unsigned int s) {
+      forwardGroups<T, A>(slots, subnetGroup[s], subnetGroup[s + 1]);
+    });
+  } else {
+    forwardGroups<T, A>(slots, 0, groupKind.size());
+  }
+}
+
+void CompiledNetwork::forward(double* slots, unsigned int first,
+                              unsigned int last, bool shared) {
+  if (shared) {
+    forwardGroups<double, double, true>(slots, first, last);
+  } else {
+    forwardGroups<double, double>(slots, first, last);
+  }
+}
+
+template <typename T, typename A, bool SHARED>
+void CompiledNetwork::forwardGroups(T* slots, unsigned int first,
+                                    unsigned int last) {
+  for (unsigned int g = first; g < last; g++) {
+    switch (groupKind[g]) {
+      case SIGMOID_ACTIVATION:
+        forwardGroup<SIGMOID_ACTIVATION, T, A, SHARED>(slots, groupStart[g], groupStart[g + 1]);
+        break;
+      case STEP_ACTIVATION:
+        forwardGroup<STEP_ACTIVATION, T, A, SHARED>(slots, groupStart[g], groupStart[g + 1]);
+        break;
+      case BIPOLAR_ACTIVATION:
+        forwardGroup<BIPOLAR_ACTIVATION, T, A, SHARED>(slots, groupStart[g], groupStart[g + 1]);
+        break;
+      default:
+        forwardGroup<LINEAR_ACTIVATION, T, A, SHARED>(slots, groupStart[g], groupStart[g + 1]);
+    }
+  }
+}
+
+template <int KIND, typename T, typename A, bool SHARED>
+void CompiledNetwork::forwardGroup(T* slots, unsigned int first,
+                                   unsigned int last) {
+  T* weights = const_cast<T*>(weightData<T>());
+  // the weights updated by other threads are read as atomics, which on the
+  // usual targets are plain loads that the compiler may not merge
+  auto weight = [weights](unsigned int i) -> T {
+    if constexpr (SHARED) {
+      return std::atomic_ref<T>(weights[i]).load(std::memory_order_relaxed);
+    } else {
+      return weights[i];
+    }
+  };
+  T* slot = slots + leaves.size();
+  for (unsigned int n = first; n < last; n++) {
+    unsigned int block = weightOffset[n];
+    T threshold = weight(block);
+    // the threshold of a step node is compared with the sum instead
+    A value = KIND == STEP_ACTIVATION ? 0 : threshold;
+    for (unsigned int e = rowStart[n], k = 1; e < rowStart[n + 1]; e++, k++) {
+      value += slots[column[e]] * (A)weight(block + k);
+    }
+    if (KIND == STEP_ACTIVATION) {
+      slot[n] = value >= threshold ? 1 : 0;
+    } else {
+      slot[n] = value;
+    }
+  }
+
+  // the nodes of a group are contiguous, so their activations are applied
+  // by a single call to the kernels
+  if (KIND == SIGMOID_ACTIVATION) {
+    applyKernel(slot + first, last - first, [&](double* v, unsigned int c) {
+      kernels::sigmoid(v, c, accuracy);
+    });
+  } else if (KIND == BIPOLAR_ACTIVATION) {
+    applyKernel(slot + first, last - first, [&](double* v, unsigned int c) {
+      kernels::bipolar(v, c, beta[first], accuracy);
+    });
+  }
+}
+
+}  // namespace neural
+}  // namespace nalso
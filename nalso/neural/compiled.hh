@@ -0,0 +1,491 @@
+#pragma once
+/**
+ * @file compiled.hh
+ *
+ * @brief Flat evaluation plan for feed forward networks.
+ *
+ * Contains the declaration of the compiled representation of a feed forward
+ * neural network, which replaces the recursive evaluation of the node graph
+ * by a single forward loop over index arrays.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "nalso/neural/kernels.hh"
+#include "nalso/neural/node.hh"
+#include "nalso/utils/aligned.hh"
+#include "nalso/utils/threadpool.hh"
+
+namespace nalso {
+namespace neural {
+
+/**
+ * Activation functions the compiled plan knows how to apply without calling
+ * back into a NeuralMethod object.
+ */
+enum ActivationKind {
+  LINEAR_ACTIVATION = 0,
+  SIGMOID_ACTIVATION = 1,
+  STEP_ACTIVATION = 2,
+  BIPOLAR_ACTIVATION = 3
+};
+
+/**
+ * Precision of the weights, values and weighted sums used to evaluate a
+ * compiled network.
+ *
+ * DOUBLE_PRECISION keeps everything in double, as the graph does.
+ * FLOAT_PRECISION keeps weights, values and sums in float, halving the memory
+ * read per connection. MIXED_PRECISION stores weights and values in float but
+ * accumulates the weighted sums in double, so long sums do not lose precision.
+ * The activations are always computed in double.
+ */
+enum Precision { DOUBLE_PRECISION = 0, FLOAT_PRECISION = 1, MIXED_PRECISION = 2 };
+
+/**
+ * @brief A feed forward network flattened into index arrays.
+ *
+ * The nodes of the network are topologically sorted once, grouped by
+ * subnetwork, and their incoming connections are stored in compressed sparse
+ * row (CSR) form: the incoming edges of the node at position n are the
+ * entries [rowStart[n], rowStart[n + 1]) of the column and weights arrays.
+ *
+ * The parameters of all the nodes live in a single aligned weight arena. Each
+ * node holds the offset of its block in the arena, whose first element is the
+ * bias followed by the weights of its incoming connections, the same layout
+ * used by NeuralNode. The arena is split in sections of equal size, one for
+ * the current weights, one for the best weights and one for the last change
+ * of each weight, so saving or restoring the weights of the whole network is
+ * a single copy between two sections.
+ *
+ * Every value lives in a slot of a single array. The first slots hold the
+ * input ends (in the same order as the inputs of the network they were built
+ * from), the rest hold the nodes in evaluation order. Evaluating the network
+ * is then one loop over the nodes which never follows a pointer.
+ *
+ * Inside each subnetwork the nodes are ordered by level and activation, so
+ * they form groups of nodes which share their activation function. Each group
+ * is evaluated by a loop specialised for its activation, which is chosen once
+ * per group instead of once per node.
+ *
+ * Inference can run in single precision, see Precision. The arena always
+ * holds the weights in double, which is what training updates, and a single
+ * precision copy of the WEIGHTS section is refreshed before evaluating when
+ * the weights have changed.
+ *
+ * The plan is a snapshot: changing the graph or the weights of the nodes
+ * after compiling requires compiling again.
+ */
+class CompiledNetwork {
+ private:
+  /** Input ends in slot order, the first numInputs are the network inputs */
+  std::vector<NeuralEndPtr> leaves;
+  unsigned int numInputs;
+
+  /** Nodes of the graph in evaluation order */
+  std::vector<NeuralNodePtr> sources;
+  /** Subnetwork n occupies the nodes [subnetStart[n], subnetStart[n + 1]) */
+  std::vector<unsigned int> subnetStart;
+  /** false if some connection links nodes of two different subnetworks */
+  bool independent;
+
+  utils::ThreadPoolPtr pool;
+  KernelAccuracy accuracy;
+  Precision precision;
+
+  std::vector<int> kind;
+  std::vector<double> beta;
+
+  /**
+   * Group g holds the nodes [groupStart[g], groupStart[g + 1]), all of the
+   * same level and activation, and subnetwork s the groups
+   * [subnetGroup[s], subnetGroup[s + 1]).
+   */
+  std::vector<unsigned int> groupStart;
+  std::vector<int> groupKind;
+  std::vector<unsigned int> subnetGroup;
+
+  std::vector<unsigned int> rowStart;
+  std::vector<unsigned int> column;
+
+  /** Offset of the block of each node inside every section of the arena */
+  std::vector<unsigned int> weightOffset;
+  /** Size of each section of the arena, padded to a cache line */
+  unsigned int sectionSize;
+  utils::AlignedVector<double> arena;
+  /** Whether each section after NO_SECTIONS was released by its owner */
+  std::vector<bool> releasedSections;
+
+  /** Slot that feeds each output end, -1 for unconnected outputs */
+  std::vector<int> outputSource;
+
+  utils::AlignedVector<double> values;
+  /** Slot major scratch used by evaluateBatch, BATCH_TILE values per slot */
+  utils::AlignedVector<double> tile;
+
+  /** Single precision copies used unless the precision is DOUBLE_PRECISION */
+  utils::AlignedVector<float> floatWeights;
+  utils::AlignedVector<float> floatValues;
+  utils::AlignedVector<float> floatTile;
+  /** true if floatWeights no longer matches the WEIGHTS section */
+  bool floatStale;
+  /** Number of times the WEIGHTS section was reported as modified */
+  unsigned long weightVersion;
+
+  CompiledNetwork()
+      : numInputs(0),
+        independent(true),
+        accuracy(EXACT_ACCURACY),
+        precision(DOUBLE_PRECISION),
+        sectionSize(0),
+        floatStale(true),
+        weightVersion(0) {}
+
+  /**
+   * Returns the weights used by the loops working with values of type T.
+   */
+  template <typename T>
+  const T* weightData() {
+    if constexpr (std::is_same_v<T, float>) {
+      return floatWeights.data();
+    } else {
+      return section(WEIGHTS);
+    }
+  }
+  /**
+   * Copies the WEIGHTS section into floatWeights if it changed.
+   */
+  void syncFloatWeights();
+
+  /**
+   * Tells whether the subnetworks are worth evaluating in parallel.
+   */
+  bool parallel() {
+    return pool.get() && independent && noSubNN() > 1 &&
+           column.size() >= PARALLEL_MIN_CONNECTIONS;
+  }
+
+  /**
+   * Runs the forward loop once the input slots are filled, in the precision
+   * of the plan.
+   */
+  void forward();
+  /**
+   * Runs the forward loop in single precision, copying the input slots to
+   * floatValues and the output slots back to values.
+   *
+   * @tparam A The type of the weighted sums.
+   */
+  template <typename A>
+  void forwardFloat();
+  /**
+   * Runs the forward loop over all the groups, one subnetwork per thread of
+   * the pool when the subnetworks are independent.
+   */
+  template <typename T, typename A>
+  void forwardSubnetworks(T* slots);
+  /**
+   * Runs the forward loop over the groups in [first, last) in double
+   * precision.
+   *
+   * @param slots The array of slots to read the inputs from and to write the
+   * values of the nodes to, either values or a private copy of it.
+   *
+   * @param shared true when other threads may update the weights meanwhile,
+   * as in Hogwild training, in which case they are read through relaxed
+   * atomics.
+   */
+  void forward(double* slots, unsigned int first, unsigned int last,
+               bool shared = false);
+  /**
+   * Runs the forward loop over the groups in [first, last).
+   *
+   * @tparam T The type of the slots and weights.
+   *
+   * @tparam A The type of the weighted sums.
+   *
+   * @tparam SHARED Whether the weights are read through relaxed atomics.
+   */
+  template <typename T, typename A, bool SHARED = false>
+  void forwardGroups(T* slots, unsigned int first, unsigned int last);
+  /**
+   * Runs the forward loop over the nodes in [first, last), which share the
+   * activation KIND, so the activation is resolved at compile time.
+   */
+  template <int KIND, typename T, typename A, bool SHARED = false>
+  void forwardGroup(T* slots, unsigned int first, unsigned int last);
+
+  /**
+   * Evaluates many input vectors at once using the given scratch tile.
+   */
+  template <typename T, typename A>
+  void evaluateTiles(utils::AlignedVector<T>& buffer, std::span<const double> input,
+                     std::span<double> output, unsigned int rows);
+  /**
+   * Runs the forward loop over the nodes in [first, last) for a tile of
+   * samples stored slot major, so every operation works on the contiguous
+   * values of one slot for all the samples.
+   *
+   * @param count The number of samples in the tile, at most BATCH_TILE.
+   */
+  template <typename T, typename A>
+  void forwardTile(T* buffer, unsigned int count, unsigned int first,
+                   unsigned int last);
+
+  friend class Trainer;
+  friend class TernaryNetwork;
+  friend class SlicedNetwork;
+  friend class TruthTableSweeper;
+  friend class IncrementalNetwork;
+  friend class RecurrentNetwork;
+
+ public:
+  /** Sections of the weight arena */
+  enum ArenaSection { WEIGHTS = 0, BEST_WEIGHTS = 1, CHANGE_IN_WEIGHTS = 2, NO_SECTIONS = 3 };
+
+  /** Number of samples evaluated together by evaluateBatch */
+  static constexpr unsigned int BATCH_TILE = 32;
+  /** Smaller plans are always evaluated by a single thread */
+  static constexpr unsigned int PARALLEL_MIN_CONNECTIONS = 4096;
+
+  /**
+   * Builds the evaluation plan of the network formed by the given ends and
+   * nodes.
+   *
+   * @param inputs The input ends of the network. Their position in the vector
+   * is the position of their slot.
+   *
+   * @param outputs The output ends of the network. Their position in the vector
+   * is the index used by outputValue.
+   *
+   * @param nodes The nodes of the network, one vector per subnetwork.
+   *
+   * @return A pointer to the plan or an empty pointer if the network can not be
+   * compiled, either because it contains a cycle, because one of its nodes
+   * uses an activation method unknown to the plan or because an output end has
+   * more than one input.
+   */
+  static std::shared_ptr<CompiledNetwork> compile(
+      const std::vector<NeuralEndPtr>& inputs,
+      const std::vector<NeuralEndPtr>& outputs,
+      const std::vector<std::vector<NeuralNodePtr> >& nodes);
+
+  /**
+   * Reads the current value of the input ends and computes the value of every
+   * node in the plan.
+   */
+  void evaluate();
+
+  /**
+   * Computes the value of every node in the plan taking the inputs from a
+   * buffer instead of the input ends, and writes the outputs into another
+   * buffer. It neither allocates nor touches the nodes of the graph.
+   *
+   * @param input The value of each input, indexed by input port. It must
+   * contain noInputs() elements.
+   *
+   * @param output Buffer where the value of each output, indexed by output
+   * port, is written. It must contain noOutputs() elements.
+   */
+  void evaluate(std::span<const double> input, std::span<double> output);
+
+  /**
+   * Evaluates many input vectors at once. The samples are processed in tiles
+   * of BATCH_TILE rows which are transposed so that each connection becomes a
+   * multiply and add over the contiguous values of a whole tile, i.e. each
+   * layer is computed as the product of its sparse weight matrix and a dense
+   * block of samples, which the compiler turns into SIMD instructions.
+   *
+   * @param input Row major matrix with one row of noInputs() values per
+   * sample, indexed by input port.
+   *
+   * @param output Row major matrix with room for one row of noOutputs()
+   * values per sample, indexed by output port.
+   *
+   * @param rows The number of samples.
+   */
+  void evaluateBatch(std::span<const double> input, std::span<double> output,
+                     unsigned int rows);
+
+  /**
+   * Returns the value computed for the output at the given index by the last
+   * call to evaluate.
+   *
+   * @param index Position of the output end in the vector used to compile.
+   *
+   * @return The value of the output.
+   */
+  double outputValue(unsigned int index) {
+    return outputSource[index] < 0 ? 0 : values[outputSource[index]];
+  }
+
+  /**
+   * Returns the number of inputs of the plan.
+   *
+   * @return The number of input ports.
+   */
+  unsigned int noInputs() { return numInputs; }
+  /**
+   * Returns the number of outputs of the plan.
+   *
+   * @return The number of output ports.
+   */
+  unsigned int noOutputs() { return outputSource.size(); }
+  /**
+   * Returns the number of computing nodes in the plan.
+   *
+   * @return The number of nodes in the plan.
+   */
+  unsigned int noNodes() { return sources.size(); }
+  /**
+   * Returns the number of groups of nodes of the same level and activation.
+   *
+   * @return The number of groups in the plan.
+   */
+  unsigned int noGroups() { return groupKind.size(); }
+  /**
+   * Returns the number of connections between nodes in the plan.
+   *
+   * @return The number of weighted connections in the plan.
+   */
+  unsigned int noConnections() { return column.size(); }
+  /**
+   * Return the number of subnetworks of the plan.
+   *
+   * @return The number of subnetworks of the plan.
+   */
+  unsigned int noSubNN() { return subnetStart.size() - 1; }
+  /**
+   * Tells whether the subnetworks of the plan are disconnected from each
+   * other. When they are not, the plan keeps all the nodes in a single
+   * subnetwork and evaluates them in order.
+   *
+   * @return true if no connection crosses two subnetworks.
+   */
+  bool independentSubnetworks() { return independent; }
+
+  /**
+   * Returns the start of a section of the weight arena. The block of the node
+   * at position n of the plan starts at getWeightOffset(n) in every section.
+   *
+   * @param index The section, one of ArenaSection.
+   *
+   * @return A pointer to the first element of the section.
+   */
+  double* section(unsigned int index) { return arena.data() + index * sectionSize; }
+  /**
+   * Adds zeroed sections to the weight arena, e.g. to hold the state of an
+   * optimiser next to the weights it updates. Released sections are reused
+   * when enough of them are contiguous, otherwise the sections are appended
+   * and pointers previously returned by section are invalidated.
+   *
+   * @param count The number of sections to add.
+   *
+   * @return The index of the first section added.
+   */
+  unsigned int addSections(unsigned int count);
+  /**
+   * Gives back sections obtained from addSections, so later calls can reuse
+   * them. Released sections at the end of the arena are freed.
+   *
+   * @param first The index returned by addSections.
+   *
+   * @param count The number of sections to release.
+   */
+  void releaseSections(unsigned int first, unsigned int count);
+  /**
+   * Returns the number of sections of the weight arena.
+   *
+   * @return NO_SECTIONS plus the number of sections added with addSections
+   * and not freed yet.
+   */
+  unsigned int noSections() {
+    return sectionSize ? arena.size() / sectionSize : (unsigned int)NO_SECTIONS;
+  }
+  /**
+   * Returns the number of elements of each section of the weight arena.
+   *
+   * @return the size of a section, a multiple of a cache line.
+   */
+  unsigned int getSectionSize() { return sectionSize; }
+  /**
+   * Returns the offset of the block of the given node in the weight arena. The
+   * block holds the bias followed by the weights of the incoming connections
+   * of the node.
+   *
+   * @param node The position of the node in the plan.
+   *
+   * @return The offset of the block of the node in each section.
+   */
+  unsigned int getWeightOffset(unsigned int node) { return weightOffset[node]; }
+
+  /**
+   * Saves the current weights as the best ones. It is a single copy between
+   * two sections of the arena.
+   */
+  void saveWeights();
+  /**
+   * Restores the weights previously saved with saveWeights.
+   */
+  void restoreWeights();
+  /**
+   * Copies the weights of the arena back into the nodes of the graph the plan
+   * was compiled from, e.g. once training is over.
+   */
+  void writeBack();
+
+  /**
+   * Sets the pool used to evaluate independent subnetworks in parallel. An
+   * empty pointer makes the plan run in the calling thread only.
+   *
+   * @param _pool The thread pool to use.
+   */
+  void setThreadPool(utils::ThreadPoolPtr _pool) { pool = _pool; }
+
+  /**
+   * Sets how the exponentials of the sigmoid and bipolar nodes are computed.
+   * The default, EXACT_ACCURACY, gives the same values as the recursive
+   * evaluation of the graph, see KernelAccuracy for the error bound of the
+   * fast mode.
+   *
+   * @param _accuracy The accuracy of the activation kernels.
+   */
+  void setAccuracy(KernelAccuracy _accuracy) { accuracy = _accuracy; }
+  KernelAccuracy getAccuracy() { return accuracy; }
+
+  /**
+   * Sets the precision used by evaluate and evaluateBatch. Training always
+   * runs in double precision.
+   *
+   * @param _precision The precision of the weights, values and sums.
+   */
+  void setPrecision(Precision _precision);
+  Precision getPrecision() { return precision; }
+
+  /**
+   * Tells the plan that the WEIGHTS section was modified through section, so
+   * the single precision copy is refreshed before the next evaluation. The
+   * Trainer and restoreWeights call it themselves.
+   */
+  void weightsChanged() {
+    floatStale = true;
+    weightVersion++;
+  }
+  /**
+   * Returns a number which changes every time weightsChanged is called, so
+   * the evaluators which copy the weights can tell when they are stale.
+   *
+   * @return The version of the weights.
+   */
+  unsigned long getWeightVersion() { return weightVersion; }
+};
+
+typedef std::shared_ptr<CompiledNetwork> CompiledNetworkPtr;
+
+}  // namespace neural
+}  // namespace nalso
@@ -0,0 +1,341 @@
+/**
+ * @file compiledhopfield.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "compiledhopfield.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace nalso {
+namespace neural {
+
+CompiledHopfieldPtr CompiledHopfield::compile(
+    const std::map<std::string, HopfieldNodePtr>& _nodes,
+    std::shared_ptr<double> _coolingFactor) {
+  CompiledHopfieldPtr res(new CompiledHopfield);
+  res->coolingFactor = _coolingFactor;
+
+  std::map<HopfieldNode*, unsigned int> number;
+  for (auto nit = _nodes.begin(); nit != _nodes.end(); nit++) {
+    number.insert(std::make_pair((*nit).second.get(), res->sources.size()));
+    res->sources.push_back((*nit).second);
+  }
+
+  // every hyperedge is listed by each of its nodes, once per time the node
+  // is in it, and gets its record the first time it is seen
+  std::map<HyperConnection*, unsigned int> seen;
+  unsigned int blockStart = 0;
+  res->edgeBlocks.push_back(0);
+  res->incidenceStart.push_back(0);
+  for (unsigned int n = 0; n < res->sources.size(); n++) {
+    const std::list<HyperConnectionPtr>& inputs = res->sources[n]->getInputs();
+    std::map<unsigned int, unsigned int> listed;
+    for (auto hcit = inputs.begin(); hcit != inputs.end(); hcit++) {
+      auto found = seen.find((*hcit).get());
+      if (found == seen.end()) {
+        if (res->members.size() - blockStart >= SLOTS_PER_TASK) {
+          // the next block of hyperedges starts on a cache line
+          unsigned int lines = (res->members.size() + LINE_FLOATS - 1) / LINE_FLOATS;
+          res->members.resize(lines * LINE_FLOATS, 0);
+          res->edgeBlocks.push_back(res->edges.size());
+          blockStart = res->members.size();
+        }
+        HyperEdge edge;
+        edge.weight = (**hcit).first;
+        edge.offset = res->members.size();
+        edge.order = (**hcit).second.size();
+        for (auto nit = (**hcit).second.begin(); nit != (**hcit).second.end(); nit++) {
+          auto member = number.find((*nit).get());
+          if (member == number.end()) return CompiledHopfieldPtr();
+          res->members.push_back((*member).second);
+        }
+        std::vector<unsigned int> sorted(res->members.begin() + edge.offset,
+                                         res->members.end());
+        std::sort(sorted.begin(), sorted.end());
+        edge.repeated = std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end();
+        found = seen.insert(std::make_pair((*hcit).get(), res->edges.size())).first;
+        res->edges.push_back(edge);
+      }
+
+      // the k-th time the node lists the hyperedge takes its k-th slot there
+      const HyperEdge& edge = res->edges[(*found).second];
+      unsigned int skip = listed[(*found).second]++;
+      unsigned int slot = edge.offset;
+      for (; slot < edge.offset + edge.order; slot++) {
+        if (res->members[slot] == n && skip-- == 0) break;
+      }
+      if (slot == edge.offset + edge.order) return CompiledHopfieldPtr();
+      res->incidence.push_back(slot);
+      res->incidenceEdge.push_back((*found).second);
+    }
+    res->incidenceStart.push_back(res->incidence.size());
+  }
+  res->edgeBlocks.push_back(res->edges.size());
+  res->assignColours();
+
+  res->potential.resize(res->sources.size());
+  res->nextPotential.resize(res->sources.size());
+  res->terms.resize(res->members.size());
+  res->output.resize(res->sources.size());
+  res->previous.resize(res->sources.size());
+  return res;
+}
+
+void CompiledHopfield::assignColours() {
+  unsigned int nodes = sources.size();
+  std::vector<unsigned int> byDegree(nodes);
+  for (unsigned int n = 0; n < nodes; n++) byDegree[n] = n;
+  std::stable_sort(byDegree.begin(), byDegree.end(), [this](unsigned int a, unsigned int b) {
+    return incidenceStart[a + 1] - incidenceStart[a] > incidenceStart[b + 1] - incidenceStart[b];
+  });
+
+  // greedy colouring, each node takes the lowest colour none of the nodes
+  // sharing a hyperedge with it took, marked with the node plus one
+  nodeColour.assign(nodes, nodes);
+  std::vector<unsigned int> taken;
+  for (unsigned int k = 0; k < nodes; k++) {
+    unsigned int n = byDegree[k];
+    for (unsigned int i = incidenceStart[n]; i < incidenceStart[n + 1]; i++) {
+      const HyperEdge& edge = edges[incidenceEdge[i]];
+      for (unsigned int m = edge.offset; m < edge.offset + edge.order; m++) {
+        unsigned int other = members[m];
+        if (other != n && nodeColour[other] < nodes) taken[nodeColour[other]] = n + 1;
+      }
+    }
+    unsigned int c = 0;
+    while (c < taken.size() && taken[c] == n + 1) c++;
+    if (c == taken.size()) taken.push_back(0);
+    nodeColour[n] = c;
+  }
+
+  // the nodes sorted by colour, then by number
+  unsigned int colours = taken.size();
+  std::vector<unsigned int> start(colours + 1, 0);
+  for (unsigned int n = 0; n < nodes; n++) start[nodeColour[n] + 1]++;
+  for (unsigned int c = 0; c < colours; c++) start[c + 1] += start[c];
+  colourNodes.resize(nodes);
+  std::vector<unsigned int> fill(start.begin(), start.end() - 1);
+  for (unsigned int n = 0; n < nodes; n++) colourNodes[fill[nodeColour[n]]++] = n;
+
+  // a block only ends where the next node is on another cache line
+  colourBlocks.clear();
+  colourBlockStart.clear();
+  for (unsigned int c = 0; c < colours; c++) {
+    colourBlockStart.push_back(colourBlocks.size());
+    colourBlocks.push_back(start[c]);
+    for (unsigned int k = start[c] + 1; k < start[c + 1]; k++) {
+      if (k - colourBlocks.back() >= NODES_PER_TASK &&
+          colourNodes[k] / LINE_FLOATS != colourNodes[k - 1] / LINE_FLOATS) {
+        colourBlocks.push_back(k);
+      }
+    }
+  }
+  colourBlockStart.push_back(colourBlocks.size());
+  colourBlocks.push_back(nodes);
+}
+
+void CompiledHopfield::run(unsigned int count,
+                           const std::function<void(unsigned int)>& task) {
+  if (pool.get() && count > 1) {
+    pool->parallelFor(count, task);
+  } else {
+    for (unsigned int i = 0; i < count; i++) task(i);
+  }
+}
+
+void CompiledHopfield::computeOutputs(std::span<const double> from,
+                                      std::span<double> to) {
+  double cooling = *coolingFactor;
+  if (accuracy == FAST_ACCURACY) {
+    for (unsigned int n = 0; n < from.size(); n++) to[n] = from[n] / cooling;
+    kernels::sigmoid(to.data(), to.size(), accuracy);
+    return;
+  }
+  for (unsigned int n = 0; n < from.size(); n++) {
+    to[n] = 1 / (1 + std::exp(-from[n] / cooling));
+  }
+}
+
+template <typename T, typename A>
+void CompiledHopfield::computeTerms(unsigned int block) {
+  const T* out = outputData<T>();
+  for (unsigned int e = edgeBlocks[block]; e < edgeBlocks[block + 1]; e++) {
+    const HyperEdge& edge = edges[e];
+    const unsigned int* member = members.data() + edge.offset;
+    T* term = termData<T>() + edge.offset;
+
+    // a hyperedge of only one node does not count
+    if (edge.order == 1) {
+      term[0] = 0;
+    } else if (edge.repeated) {
+      // every copy of a node is left out of its products
+      for (unsigned int j = 0; j < edge.order; j++) {
+        A mult = weightOf<T>(e);
+        for (unsigned int i = 0; i < edge.order; i++) {
+          if (member[i] != member[j]) mult *= out[member[i]];
+        }
+        term[j] = mult;
+      }
+    } else {
+      // the weight times the outputs before each member, then times the
+      // outputs after it walking back, so no output is divided out
+      A prefix = weightOf<T>(e);
+      for (unsigned int j = 0; j < edge.order; j++) {
+        term[j] = prefix;
+        prefix *= out[member[j]];
+      }
+      A suffix = 1;
+      for (unsigned int j = edge.order; j-- > 0;) {
+        term[j] = term[j] * suffix;
+        suffix *= out[member[j]];
+      }
+    }
+  }
+}
+
+template <typename T, typename A>
+bool CompiledHopfield::computeNextPotentials(unsigned int block, double tolerance) {
+  unsigned int first = block * NODES_PER_TASK;
+  unsigned int last = std::min<unsigned int>(first + NODES_PER_TASK, sources.size());
+  const T* term = termData<T>();
+  for (unsigned int n = first; n < last; n++) {
+    A sum = 0;
+    for (unsigned int i = incidenceStart[n]; i < incidenceStart[n + 1]; i++) {
+      sum += term[incidence[i]];
+    }
+    nextPotential[n] = sum + potential[n];
+  }
+
+  // the outputs of the previous sweep are not read any more, their buffer
+  // takes the new ones
+  computeOutputs(std::span<const double>(nextPotential).subspan(first, last - first),
+                 std::span<double>(previous).subspan(first, last - first));
+  if constexpr (std::is_same_v<T, float>) {
+    std::copy(previous.begin() + first, previous.begin() + last, floatPrevious.begin() + first);
+  }
+  for (unsigned int n = first; n < last; n++) {
+    if (std::fabs(previous[n] - output[n]) > tolerance) return false;
+  }
+  return true;
+}
+
+template <typename T, typename A>
+bool CompiledHopfield::sweep(double tolerance) {
+  run(edgeBlocks.size() - 1, [this](unsigned int block) { computeTerms<T, A>(block); });
+
+  // parallelFor returns once every term is written
+  std::atomic<bool> equal(true);
+  unsigned int blocks = (sources.size() + NODES_PER_TASK - 1) / NODES_PER_TASK;
+  run(blocks, [this, tolerance, &equal](unsigned int block) {
+    if (!computeNextPotentials<T, A>(block, tolerance)) {
+      equal.store(false, std::memory_order_relaxed);
+    }
+  });
+
+  potential.swap(nextPotential);
+  output.swap(previous);
+  if constexpr (std::is_same_v<T, float>) floatOutput.swap(floatPrevious);
+  return equal.load();
+}
+
+template <typename T, typename A>
+bool CompiledHopfield::updateNodes(unsigned int block, double tolerance) {
+  const T* out = outputData<T>();
+  bool equal = true;
+  for (unsigned int k = colourBlocks[block]; k < colourBlocks[block + 1]; k++) {
+    unsigned int n = colourNodes[k];
+    A sum = 0;
+    for (unsigned int i = incidenceStart[n]; i < incidenceStart[n + 1]; i++) {
+      unsigned int e = incidenceEdge[i];
+      const HyperEdge& edge = edges[e];
+      A mult = edge.order == 1 ? 0 : weightOf<T>(e);
+      for (unsigned int m = edge.offset; m < edge.offset + edge.order; m++) {
+        if (members[m] != n) mult *= out[members[m]];
+      }
+      sum += mult;
+    }
+    potential[n] = sum + potential[n];
+
+    double value = potential[n];
+    computeOutputs(std::span<const double>(&value, 1), std::span<double>(&value, 1));
+    if (std::fabs(value - output[n]) > tolerance) equal = false;
+    output[n] = value;
+    if constexpr (std::is_same_v<T, float>) floatOutput[n] = value;
+  }
+  return equal;
+}
+
+template <typename T, typename A>
+bool CompiledHopfield::sweepColours(double tolerance) {
+  std::atomic<bool> equal(true);
+  for (unsigned int c = 0; c < noColours(); c++) {
+    unsigned int first = colourBlockStart[c];
+    // parallelFor returns once the colour is done, before the next one reads it
+    run(colourBlockStart[c + 1] - first, [this, first, tolerance, &equal](unsigned int block) {
+      if (!updateNodes<T, A>(first + block, tolerance)) {
+        equal.store(false, std::memory_order_relaxed);
+      }
+    });
+  }
+  return equal.load();
+}
+
+bool CompiledHopfield::iterate(double tolerance) {
+  bool async = mode == ASYNCHRONOUS_UPDATE;
+  switch (precision) {
+    case FLOAT_PRECISION:
+      return async ? sweepColours<float, float>(tolerance) : sweep<float, float>(tolerance);
+    case MIXED_PRECISION:
+      return async ? sweepColours<float, double>(tolerance) : sweep<float, double>(tolerance);
+    default:
+      return async ? sweepColours<double, double>(tolerance) : sweep<double, double>(tolerance);
+  }
+}
+
+void CompiledHopfield::setPrecision(Precision _precision) {
+  precision = _precision;
+  if (precision == DOUBLE_PRECISION) {
+    floatWeights = std::vector<float>();
+    floatTerms = utils::AlignedVector<float>();
+    floatOutput = utils::AlignedVector<float>();
+    floatPrevious = utils::AlignedVector<float>();
+    return;
+  }
+  floatWeights.resize(edges.size());
+  for (unsigned int e = 0; e < edges.size(); e++) floatWeights[e] = edges[e].weight;
+  floatTerms.resize(terms.size());
+  floatOutput.resize(output.size());
+  floatPrevious.resize(previous.size());
+}
+
+FixPointResult CompiledHopfield::findFixPoint(double tolerance,
+                                              const FixPointBudget& budget) {
+  for (unsigned int n = 0; n < sources.size(); n++) {
+    potential[n] = sources[n]->getPotential();
+  }
+  computeOutputs(potential, output);
+  if (precision != DOUBLE_PRECISION) {
+    std::copy(output.begin(), output.end(), floatOutput.begin());
+  }
+
+  FixPointMonitor monitor(budget, tolerance);
+  while (true) {
+    if (iterate(tolerance)) {
+      monitor.converged();
+      break;
+    }
+    if (!monitor.proceed(output)) break;
+  }
+
+  for (unsigned int n = 0; n < sources.size(); n++) {
+    sources[n]->setInitialPotential(potential[n]);
+  }
+  return monitor.getResult();
+}
+
+}  // namespace neural
+}  // namespace nalso
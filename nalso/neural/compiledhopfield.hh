@@ -0,0 +1,350 @@
+#pragma once
+/**
+ * @file compiledhopfield.hh
+ *
+ * @brief Flat representation of a Hopfield network.
+ *
+ * Contains the declaration of a Hopfield network whose hyperedges are stored
+ * in contiguous index arrays, which is what HopfieldNeuralNetwork iterates
+ * when looking for a fixpoint.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "nalso/neural/compiled.hh"
+#include "nalso/neural/fixpoint.hh"
+#include "nalso/neural/hopfield.hh"
+#include "nalso/neural/kernels.hh"
+#include "nalso/utils/aligned.hh"
+#include "nalso/utils/threadpool.hh"
+
+namespace nalso {
+namespace neural {
+
+/**
+ * @brief A Hopfield network flattened into index arrays.
+ *
+ * The nodes are numbered in the order of their ids. Every hyperedge is a
+ * record with its weight and the range [offset, offset + order) of the array
+ * members holding the numbers of its nodes, and the hyperedges each node
+ * belongs to are listed in a second array, in the same compressed sparse row
+ * layout as the connections of CompiledNetwork. A sweep then walks the
+ * potentials by index instead of following the lists of shared pointers of
+ * HopfieldNode.
+ *
+ * Each member of a hyperedge of order k receives the weight times the
+ * product of the outputs of the other k - 1 members. Instead of computing
+ * those products for every member, which costs O(k^2), every hyperedge is
+ * visited once and multiplies the products of the outputs before and after
+ * each member, in O(k) and without dividing, so outputs equal to 0 are
+ * handled exactly. The products are associated differently from
+ * HopfieldNode::computeNextPotential, so the potentials may differ in the last
+ * bits. A hyperedge where a node appears more than once leaves every copy of
+ * the node out of its products, as HopfieldNode does, by computing them one
+ * by one.
+ *
+ * The outputs of all the nodes are computed once at the end of every sweep
+ * into one array, which the next sweep reads, so each exponential is computed
+ * once per node and sweep instead of once per hyperedge and member. With
+ * FAST_ACCURACY they are computed by the sigmoid kernel, see KernelAccuracy,
+ * which also rounds outputs closer than 1e-19 to 0 or 1 to those values.
+ *
+ * With a thread pool, each sweep runs in two parallel loops separated by a
+ * barrier: the hyperedges, in blocks of about SLOTS_PER_TASK slots, compute
+ * their terms, then the nodes, in blocks of NODES_PER_TASK, add them into
+ * their next potentials and outputs. The blocks of slots are padded to start
+ * on a cache line and the blocks of nodes are multiples of one, so no two
+ * threads write to the same line. Every value is computed as in a single
+ * thread, so the results do not depend on the pool.
+ *
+ * The products can be computed in single precision, see Precision and
+ * setPrecision. FLOAT_PRECISION reads float copies of the weights and of the
+ * outputs, multiplies and adds in float and stores the terms in float, which
+ * halves the memory the sweeps walk through. MIXED_PRECISION stores the same
+ * copies but multiplies and adds in double. The potentials, which add up the
+ * sums of every sweep, and the outputs compared with the tolerance are always
+ * kept in double.
+ *
+ * In the asynchronous mode the nodes are coloured when the network is
+ * compiled so that no two nodes of a hyperedge share a colour, greedily,
+ * taking the nodes in the most hyperedges first. Each sweep then updates one
+ * colour at a time: the nodes of a colour never read each other, so they are
+ * updated in parallel, and each colour already reads the outputs the colours
+ * before it computed in the same sweep, as the asynchronous updates of
+ * Hopfield's model do, which are the ones its convergence results assume.
+ * They tend to settle in fewer sweeps and to avoid the oscillations of the
+ * synchronous updates, and lowering the cooling factor between calls anneals
+ * the network as intended. The nodes of a colour are
+ * split in blocks of about NODES_PER_TASK which do not share cache lines.
+ * Since the outputs change between colours, each node computes the products
+ * of its hyperedges itself, in O(k) per hyperedge of order k.
+ *
+ * The hyperedges are read from the nodes when the network is compiled, so it
+ * has to be compiled again after connecting nodes. The cooling factor is
+ * shared with the network and read on every sweep.
+ */
+class CompiledHopfield {
+ public:
+  /**
+   * Floats in a cache line, the blocks of slots and nodes start on one so the
+   * float copies are not shared either
+   */
+  static const unsigned int LINE_FLOATS = 16;
+  /** Slots of members whose terms a task computes, at least */
+  static const unsigned int SLOTS_PER_TASK = 4096;
+  /** Nodes whose potentials a task computes, a multiple of LINE_FLOATS */
+  static const unsigned int NODES_PER_TASK = 1024;
+
+ private:
+  /** A hyperedge, its nodes are members[offset, offset + order) */
+  struct HyperEdge {
+    double weight;
+    unsigned int offset;
+    unsigned int order;
+    /** Whether a node appears more than once */
+    bool repeated;
+  };
+
+  /** The nodes, by number */
+  std::vector<HopfieldNodePtr> sources;
+  std::shared_ptr<double> coolingFactor;
+  KernelAccuracy accuracy;
+  Precision precision;
+  utils::ThreadPoolPtr pool;
+  UpdateMode mode;
+
+  std::vector<HyperEdge> edges;
+  /** The slots of the hyperedges, the blocks of slots padded to a cache line */
+  std::vector<unsigned int> members;
+  /** The blocks of hyperedges are [edgeBlocks[b], edgeBlocks[b + 1]) */
+  std::vector<unsigned int> edgeBlocks;
+  /**
+   * Node n is in the slots incidence[i] of members, for i in
+   * [incidenceStart[n], incidenceStart[n + 1]), in the order the hyperedges
+   * were added to it.
+   */
+  std::vector<unsigned int> incidenceStart;
+  std::vector<unsigned int> incidence;
+  /** The hyperedge of each slot in incidence */
+  std::vector<unsigned int> incidenceEdge;
+
+  /** The colour of every node */
+  std::vector<unsigned int> nodeColour;
+  /** The nodes sorted by colour */
+  std::vector<unsigned int> colourNodes;
+  /**
+   * The blocks of colourNodes are [colourBlocks[b], colourBlocks[b + 1]), and
+   * those of colour c are the b in [colourBlockStart[c], colourBlockStart[c + 1]).
+   */
+  std::vector<unsigned int> colourBlocks;
+  std::vector<unsigned int> colourBlockStart;
+  /** The weight times the outputs of the other members, for every slot */
+  utils::AlignedVector<double> terms;
+
+  /** The potential of every node and the one computed by the current sweep */
+  utils::AlignedVector<double> potential;
+  utils::AlignedVector<double> nextPotential;
+  /** The output of every node after the last sweep and the one before */
+  utils::AlignedVector<double> output;
+  utils::AlignedVector<double> previous;
+
+  /**
+   * Single precision copies of the weight of every hyperedge, of the terms and
+   * of the outputs, used unless the precision is DOUBLE_PRECISION
+   */
+  std::vector<float> floatWeights;
+  utils::AlignedVector<float> floatTerms;
+  utils::AlignedVector<float> floatOutput;
+  utils::AlignedVector<float> floatPrevious;
+
+  CompiledHopfield()
+      : accuracy(EXACT_ACCURACY), precision(DOUBLE_PRECISION), mode(SYNCHRONOUS_UPDATE) {}
+
+  /**
+   * Returns the weight of a hyperedge, the terms and the outputs read by the
+   * sweeps working with values of type T.
+   */
+  template <typename T>
+  T weightOf(unsigned int edge) {
+    if constexpr (std::is_same_v<T, float>) {
+      return floatWeights[edge];
+    } else {
+      return edges[edge].weight;
+    }
+  }
+  template <typename T>
+  T* termData() {
+    if constexpr (std::is_same_v<T, float>) {
+      return floatTerms.data();
+    } else {
+      return terms.data();
+    }
+  }
+  template <typename T>
+  const T* outputData() {
+    if constexpr (std::is_same_v<T, float>) {
+      return floatOutput.data();
+    } else {
+      return output.data();
+    }
+  }
+
+  /**
+   * Colours the nodes so no two nodes of a hyperedge share a colour and
+   * splits every colour in blocks.
+   */
+  void assignColours();
+
+  /**
+   * Calls task(i) for every i in [0, count), in the threads of the pool if
+   * there is one.
+   */
+  void run(unsigned int count, const std::function<void(unsigned int)>& task);
+  /**
+   * Computes the outputs of a range of nodes from their potentials.
+   */
+  void computeOutputs(std::span<const double> from, std::span<double> to);
+  /**
+   * Computes the term of every slot of a block of hyperedges from the current
+   * outputs.
+   *
+   * @tparam T The type of the weights, outputs and terms read and written.
+   *
+   * @tparam A The type the products are computed in.
+   */
+  template <typename T, typename A>
+  void computeTerms(unsigned int block);
+  /**
+   * Computes the next potential and output of a block of nodes, as
+   * HopfieldNode::computeNextPotential does, adding the terms of their slots.
+   * Tells whether no output moved by more than the tolerance.
+   */
+  template <typename T, typename A>
+  bool computeNextPotentials(unsigned int block, double tolerance);
+  /**
+   * Runs one sweep and tells whether no output moved by more than the
+   * tolerance.
+   */
+  template <typename T, typename A>
+  bool sweep(double tolerance);
+  /**
+   * Updates the potential and output of every node of a block of a colour
+   * from the current outputs. Tells whether no output moved by more than the
+   * tolerance.
+   */
+  template <typename T, typename A>
+  bool updateNodes(unsigned int block, double tolerance);
+  /**
+   * Runs one asynchronous sweep, a colour at a time, and tells whether no
+   * output moved by more than the tolerance.
+   */
+  template <typename T, typename A>
+  bool sweepColours(double tolerance);
+  /**
+   * Runs one sweep in the selected update mode and precision.
+   */
+  bool iterate(double tolerance);
+
+ public:
+  /**
+   * Flattens the nodes of a Hopfield network and the hyperedges they belong
+   * to.
+   *
+   * @param _nodes The nodes of the network, by id.
+   *
+   * @param _coolingFactor The cooling factor of the network.
+   *
+   * @return A pointer to the compiled network or an empty pointer if a
+   * hyperedge contains a node which is not in _nodes.
+   */
+  static std::shared_ptr<CompiledHopfield> compile(
+      const std::map<std::string, HopfieldNodePtr>& _nodes,
+      std::shared_ptr<double> _coolingFactor);
+
+  /**
+   * Iterates the update of the potentials in the selected update mode,
+   * starting from the potentials of the nodes, until no output moves by more
+   * than the tolerance, a cycle is found or the budget runs out. The
+   * potentials reached are written back to the nodes.
+   *
+   * @param tolerance The largest difference between the outputs of two
+   * iterations for them to be considered equal.
+   *
+   * @param budget The limits of the iteration.
+   *
+   * @return How the iteration ended and the number of sweeps.
+   */
+  FixPointResult findFixPoint(double tolerance = 0,
+                              const FixPointBudget& budget = FixPointBudget());
+
+  /**
+   * Returns the output of a node after the last call to findFixPoint.
+   *
+   * @param node The number of the node, its position in the order of the ids.
+   *
+   * @return The output of the node.
+   */
+  double getOutput(unsigned int node) { return output[node]; }
+
+  /**
+   * Sets how the outputs of the nodes are computed, see KernelAccuracy.
+   * EXACT_ACCURACY computes the same values as HopfieldNode::outputValue.
+   *
+   * @param _accuracy The accuracy of the outputs.
+   */
+  void setAccuracy(KernelAccuracy _accuracy) { accuracy = _accuracy; }
+  KernelAccuracy getAccuracy() { return accuracy; }
+
+  /**
+   * Sets the precision of the products of the sweeps, see Precision. The
+   * single precision copies are only allocated when they are used.
+   *
+   * @param _precision The precision of the weights, outputs and terms.
+   */
+  void setPrecision(Precision _precision);
+  Precision getPrecision() { return precision; }
+
+  /**
+   * Sets the thread pool the sweeps are split across.
+   *
+   * @param _pool The pool to use, an empty pointer to sweep in the calling
+   * thread only.
+   */
+  void setThreadPool(utils::ThreadPoolPtr _pool) { pool = _pool; }
+
+  /**
+   * Selects whether the sweeps update all the nodes at once or a colour at a
+   * time, see UpdateMode.
+   *
+   * @param _mode The update mode.
+   */
+  void setUpdateMode(UpdateMode _mode) { mode = _mode; }
+  UpdateMode getUpdateMode() { return mode; }
+
+  /**
+   * Returns the colour of a node, no two nodes of a hyperedge have the same
+   * one.
+   *
+   * @param node The number of the node.
+   *
+   * @return The colour, from 0 to noColours() - 1.
+   */
+  unsigned int getColour(unsigned int node) { return nodeColour[node]; }
+  unsigned int noColours() { return colourBlockStart.size() - 1; }
+
+  unsigned int noNodes() { return sources.size(); }
+  unsigned int noEdges() { return edges.size(); }
+};
+
+typedef std::shared_ptr<CompiledHopfield> CompiledHopfieldPtr;
+
+}  // namespace neural
+}  // namespace nalso
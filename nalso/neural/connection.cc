@@ -14,7 +14,10 @@ namespace neural {
 NeuralConnection::NeuralConnection(std::string _id)
     : unitValue(NAN),
       unitError(NAN),
-      weightsUpdated(false),
+      epoch(new unsigned long(1)),
+      valueStamp(0),
+      errorStamp(0),
+      weightsStamp(0),
       id(_id),
       type(UNCONNECTED) {}
 
@@ -29,11 +32,11 @@ void NeuralConnection::updateWeights(double _learning, double _momentum) {
   // but if they coverride they should make a call to this to
   // call the method for all their inputs.
 
-  if (!weightsUpdated) {
+  if (weightsStamp != *epoch) {
+    weightsStamp = *epoch;
     for (unsigned int noa = 0; noa < inputList.size(); noa++) {
       inputList[noa]->updateWeights(_learning, _momentum);
     }
-    weightsUpdated = true;
   }
 }
 
@@ -23,21 +23,24 @@ NeuralEnd::NeuralEnd(std::string _id, bool _input /*= true*/)
 }
 
 double NeuralEnd::outputValue(bool compute) {
-  if (std::isnan(unitValue) && compute) {
-    if (input){
-      return 0;
-    } else {  // unit is an output
-      unitValue = 0;
-      for (unsigned int i = 0; i < inputList.size(); i++) {
-        unitValue += (*inputList[i]).outputValue(true);
-      }
+  // the value of an input is set from outside and survives the epochs
+  if (input) {
+    return std::isnan(unitValue) && compute ? 0 : unitValue;
+  }
+
+  if (!valueComputed() && compute) {
+    unitValue = 0;
+    for (unsigned int i = 0; i < inputList.size(); i++) {
+      unitValue += (*inputList[i]).outputValue(true);
     }
+    valueStamp = *epoch;
   }
-  return unitValue;
+  return valueComputed() ? unitValue : NAN;
 }
 
 double NeuralEnd::errorValue(bool compute) {
-  if (!std::isnan(unitValue) && std::isnan(unitError) && compute) {
+  bool hasValue = input ? !std::isnan(unitValue) : valueComputed();
+  if (hasValue && !errorComputed() && compute) {
     if (input) {
       unitError = 0;
       for (unsigned int i = 0; i < outputList.size(); i++) {
@@ -46,15 +49,14 @@ double NeuralEnd::errorValue(bool compute) {
     } else {
       unitError = expected - unitValue;
     }
+    errorStamp = *epoch;
   }
-  return unitError;
+  return errorComputed() ? unitError : NAN;
 }
 
 void NeuralEnd::reset() {
-  if (!std::isnan(unitValue) || !std::isnan(unitError)) {
-    unitValue = input ? unitValue : NAN;
-    unitError = NAN;
-    weightsUpdated = false;
+  if (valueComputed() || errorComputed()) {
+    invalidate();
     for (unsigned int i = 0; i < inputList.size(); i++) {
       inputList[i]->reset();
     }
@@ -7,6 +7,7 @@
 
 #include "feedforward.hh"
 
+#include <iterator>
 #include <sstream>
 
 #include "nalso/utils/utils.hh"
@@ -15,7 +16,12 @@ namespace nalso {
 
 namespace neural {
 
-FeedForwardNeuralNetwork::FeedForwardNeuralNetwork() {
+FeedForwardNeuralNetwork::FeedForwardNeuralNetwork()
+    : recurrentVersion(0),
+      epoch(new unsigned long(1)),
+      accuracy(EXACT_ACCURACY),
+      precision(DOUBLE_PRECISION),
+      updateMode(SYNCHRONOUS_UPDATE) {
   std::vector<NeuralNodePtr> tmp;
   nodes.push_back(tmp);
 }
@@ -29,6 +35,9 @@ FeedForwardNeuralNetwork::~FeedForwardNeuralNetwork() {
 
 void FeedForwardNeuralNetwork::addNode(NeuralNodePtr node,
                                        int subNetwork /*= 0*/) {
+  compiled.reset();
+  recurrent.reset();
+  node->setEpoch(epoch);
   // if the neuron is of type INPUT, then we create the equivalent NeuralEnd
   // object we connect the new end to the given node and add it to the inputs
   // std::vector
@@ -49,7 +58,8 @@ void FeedForwardNeuralNetwork::addNode(NeuralNodePtr node,
       id.erase(id.end() - 2, id.end());
     }
     NeuralEndPtr end(new NeuralEnd(id, true));
-    ProxyElem tmp(ss.str(), end);
+    end->setEpoch(epoch);
+    ProxyElem tmp(id, end);
     inputs.insert(tmp);
     NeuralConnection::connect(end, node, 1);
   }
@@ -72,6 +82,7 @@ void FeedForwardNeuralNetwork::addNode(NeuralNodePtr node,
     std::string comp("_o");
     if (sub == comp) id.erase(id.end() - 2, id.end());
     NeuralEndPtr end(new NeuralEnd(ss.str(), false));
+    end->setEpoch(epoch);
     ProxyElem tmp(id, end);
     outputs.insert(tmp);
     NeuralConnection::connect(node, end, 1);
@@ -85,6 +96,10 @@ void FeedForwardNeuralNetwork::addNode(NeuralNodePtr node,
 bool FeedForwardNeuralNetwork::connectNodes(NeuralConnectionPtr source,
                                             NeuralConnectionPtr dest,
                                             double weight /*=1*/) {
+  compiled.reset();
+  recurrent.reset();
+  if (source.get()) source->setEpoch(epoch);
+  if (dest.get()) dest->setEpoch(epoch);
   return NeuralConnection::connect(source, dest, weight);
 }
 
@@ -124,6 +139,25 @@ bool FeedForwardNeuralNetwork::connectNodes(std::string sourceId, std::string de
   return connectNodes(source, dest, weight);
 }
 
+bool FeedForwardNeuralNetwork::compile() {
+  std::vector<NeuralEndPtr> ins, outs;
+  for (auto it = inputs.begin(); it != inputs.end(); it++) {
+    ins.push_back((*it).second);
+  }
+  for (auto it = outputs.begin(); it != outputs.end(); it++) {
+    outs.push_back((*it).second);
+  }
+
+  compiled = CompiledNetwork::compile(ins, outs, nodes);
+  recurrent.reset();
+  if (!compiled.get()) return false;
+
+  compiled->setThreadPool(pool);
+  compiled->setAccuracy(accuracy);
+  compiled->setPrecision(precision);
+  return true;
+}
+
 ParamsMap FeedForwardNeuralNetwork::evaluate(ParamsMap& input) {
   ParamsMap::iterator it;
   for (it = input.begin(); it != input.end(); it++) {
@@ -133,6 +167,16 @@ ParamsMap FeedForwardNeuralNetwork::evaluate(ParamsMap& input) {
   }
 
   std::map<std::string, double> res;
+  if (compiled.get()) {
+    // the plan does not touch the nodes so there is nothing to reset
+    compiled->evaluate();
+    unsigned int index = 0;
+    for (auto oit = outputs.begin(); oit != outputs.end(); oit++, index++) {
+      res.insert(std::make_pair((*oit).first, compiled->outputValue(index)));
+    }
+    return res;
+  }
+
   for (auto oit = outputs.begin(); oit != outputs.end(); oit++) {
     std::pair<std::string, double> resElem((*oit).first,
                                  (*oit).second->outputValue(true));
@@ -142,19 +186,115 @@ ParamsMap FeedForwardNeuralNetwork::evaluate(ParamsMap& input) {
   return res;
 }
 
-void FeedForwardNeuralNetwork::reset() {
+void FeedForwardNeuralNetwork::saveWeights() {
+  if (compiled.get()) {
+    compiled->saveWeights();
+    return;
+  }
+  for (auto it = outputs.begin(); it != outputs.end(); it++) {
+    (*it).second->saveWeights();
+  }
+}
+
+void FeedForwardNeuralNetwork::restoreWeights() {
+  if (compiled.get()) {
+    compiled->restoreWeights();
+    return;
+  }
   for (auto it = outputs.begin(); it != outputs.end(); it++) {
-    (*(*it).second).reset();
+    (*it).second->restoreWeights();
+  }
+}
+
+ParamsMap FeedForwardNeuralNetwork::findFixPoint(ParamsMap input,
+                                                 double tolerance /* = 0*/,
+                                                 const FixPointBudget& budget,
+                                                 FixPointResult* result) {
+  if (!compiled.get() && !compile()) {
+    return NeuralNetwork::findFixPoint(input, tolerance, budget, result);
   }
 
+  // the engine copies the weights, so it is only built again when they change
+  if (!recurrent.get() || recurrentVersion != compiled->getWeightVersion()) {
+    recurrent = RecurrentNetwork::compile(compiled, feedbackPorts());
+    recurrentVersion = compiled->getWeightVersion();
+  }
+  recurrent->setUpdateMode(updateMode);
+  std::vector<double> in, out(outputs.size());
   for (auto it = inputs.begin(); it != inputs.end(); it++) {
-    (*(*it).second).reset();
+    auto value = input.find((*it).first);
+    if (value != input.end()) (*it).second->setOutputValue((*value).second);
+    in.push_back((*it).second->outputValue(true));
   }
+  FixPointResult outcome = recurrent->findFixPoint(in, out, tolerance, budget);
+  if (result) *result = outcome;
 
-  for (unsigned int i = 0; i < nodes.size(); i++) {
-    for (unsigned int j = 0; j < nodes[i].size(); j++) {
-      (*nodes[i][j]).reset();
-    }
+  // the inputs are left as in the last evaluation, as evaluate does
+  ParamsMap res;
+  unsigned int port = 0;
+  for (auto it = inputs.begin(); it != inputs.end(); it++, port++) {
+    int source = recurrent->feedbackPort(port);
+    if (source >= 0) (*it).second->setOutputValue(out[source]);
+  }
+  port = 0;
+  for (auto it = outputs.begin(); it != outputs.end(); it++, port++) {
+    res.insert(std::make_pair((*it).first, out[port]));
+  }
+  return res;
+}
+
+std::vector<int> FeedForwardNeuralNetwork::feedbackPorts() {
+  std::vector<int> res;
+  for (auto it = inputs.begin(); it != inputs.end(); it++) {
+    res.push_back(outputPort((*it).first));
+  }
+  return res;
+}
+
+int FeedForwardNeuralNetwork::inputPort(const std::string& label) {
+  auto it = inputs.find(label);
+  if (it == inputs.end()) return -1;
+  return std::distance(inputs.begin(), it);
+}
+
+int FeedForwardNeuralNetwork::outputPort(const std::string& label) {
+  auto it = outputs.find(label);
+  if (it == outputs.end()) return -1;
+  return std::distance(outputs.begin(), it);
+}
+
+void FeedForwardNeuralNetwork::evaluate(std::span<const double> input,
+                                        std::span<double> output) {
+  // the ends keep the inputs for the evaluations by label
+  unsigned int port = 0;
+  for (auto it = inputs.begin(); it != inputs.end(); it++, port++) {
+    (*it).second->setOutputValue(input[port]);
+  }
+
+  if (compiled.get() || compile()) {
+    compiled->evaluate(input, output);
+    return;
+  }
+
+  // the network can not be compiled, the recursive evaluation is used
+  port = 0;
+  for (auto it = outputs.begin(); it != outputs.end(); it++, port++) {
+    output[port] = (*it).second->outputValue(true);
+  }
+  reset();
+}
+
+void FeedForwardNeuralNetwork::evaluateBatch(std::span<const double> input,
+                                             std::span<double> output,
+                                             unsigned int rows) {
+  if (compiled.get() || compile()) {
+    compiled->evaluateBatch(input, output, rows);
+    return;
+  }
+
+  unsigned int noIns = inputs.size(), noOuts = outputs.size();
+  for (unsigned int r = 0; r < rows; r++) {
+    evaluate(input.subspan(r * noIns, noIns), output.subspan(r * noOuts, noOuts));
   }
 }
 
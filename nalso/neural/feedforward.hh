@@ -12,11 +12,16 @@
  */
 
 #include <map>
+#include <span>
+#include <string>
 #include <vector>
 
+#include "nalso/neural/compiled.hh"
 #include "nalso/neural/method.hh"
 #include "nalso/neural/neuralnetwork.hh"
 #include "nalso/neural/node.hh"
+#include "nalso/neural/recurrent.hh"
+#include "nalso/utils/threadpool.hh"
 
 namespace nalso {
 namespace neural {
@@ -29,16 +34,27 @@ typedef std::pair<std::string, NeuralEndPtr> ProxyElem;
  * Provides a fast and easy to use implementation of a Feed Forward neural
  * network. Plus it can have many subnetworks which are to some extend
  * independent from each others. The code is based on the neural network class
- * used in weka but stripped down of all the data management. It doesn't
- * implemente either the training phase althoug it would be relatively easy to
- * do.
- *
- * @todo Learning algorithms such as backpropagation
+ * used in weka but stripped down of all the data management. Training is done
+ * over the compiled plan of the network by a Trainer, see trainer.hh.
  */
 class FeedForwardNeuralNetwork : public NeuralNetwork {
  private:
   std::map<std::string, NeuralEndPtr> inputs, outputs;
   std::vector<std::vector<NeuralNodePtr> > nodes;
+  CompiledNetworkPtr compiled;
+  /**
+   * Engine used by findFixPoint, built from compiled the first time it is
+   * needed and built again when compiled or its weights change
+   */
+  RecurrentNetworkPtr recurrent;
+  /** Version of the weights of compiled the engine was built with */
+  unsigned long recurrentVersion;
+  /** evaluation epoch shared by all the nodes of the network */
+  std::shared_ptr<unsigned long> epoch;
+  utils::ThreadPoolPtr pool;
+  KernelAccuracy accuracy;
+  Precision precision;
+  UpdateMode updateMode;
 
  public:
   /**
@@ -54,7 +70,10 @@ class FeedForwardNeuralNetwork : public NeuralNetwork {
    * map. The label of this newly created NeuralEnd is
    * w$subnetwork-$node.getId(), for example a neural node in subnetwork 3 with
    * id myNode of type input will create a NeuralEnd in the input map with id
-   * w3-myNode.
+   * w3-myNode. A trailing _i is stripped from the label of an input end and a
+   * trailing _o from the label of an output end, so the nodes p_i and p_o of
+   * subnetwork 0 are both reached by the label w0-p, which pairs them in
+   * findFixPoint. The node starts sharing the evaluation epoch of the network.
    *
    * @param node A pointer to the node to be added.
    *
@@ -71,6 +90,9 @@ class FeedForwardNeuralNetwork : public NeuralNetwork {
    * it is considered to be an output node.
    */
   void addEndNode(NeuralEndPtr node, bool input = true) {
+    compiled.reset();
+    recurrent.reset();
+    node->setEpoch(epoch);
     if (input) {
       inputs.insert(make_pair((*node).getId(), node));
     } else {
@@ -82,6 +104,8 @@ class FeedForwardNeuralNetwork : public NeuralNetwork {
    * Allocates space for a new subnetwork.
    */
   void allocateSubnetwork() {
+    compiled.reset();
+    recurrent.reset();
     std::vector<NeuralNodePtr> tmp;
     nodes.push_back(tmp);
   }
@@ -110,8 +134,194 @@ class FeedForwardNeuralNetwork : public NeuralNetwork {
   bool connectNodes(std::string sourceId, std::string destId, double weight = 1,
                     int subNetSource = 0, int subNetDest = 0);
 
+  /**
+   * Topologically sorts the nodes of every subnetwork and flattens the network
+   * into a CompiledNetwork. Once compiled, evaluate runs a single forward loop
+   * over index arrays instead of the recursive evaluation of the nodes.
+   *
+   * Adding nodes or connections through the network discards the compiled
+   * plan. Weights changed directly on the nodes are not seen by the plan until
+   * compile is called again.
+   *
+   * @return true if the network was compiled, false if it contains a cycle, a
+   * node whose method is not supported by CompiledNetwork or an output end
+   * with more than one input, in which case the network keeps using the
+   * recursive evaluation.
+   */
+  bool compile();
+
+  /**
+   * Sets the thread pool used by the compiled network to evaluate independent
+   * subnetworks in parallel. Subnetworks are only evaluated in parallel when
+   * no connection crosses two of them; otherwise the nodes are evaluated in
+   * order in the calling thread.
+   *
+   * @param _pool The pool to use, an empty pointer to evaluate in the calling
+   * thread only.
+   */
+  void setThreadPool(utils::ThreadPoolPtr _pool) {
+    pool = _pool;
+    if (compiled.get()) compiled->setThreadPool(pool);
+  }
+
+  /**
+   * Sets how the compiled network computes the exponentials of the sigmoid
+   * and bipolar nodes, see KernelAccuracy.
+   *
+   * @param _accuracy The accuracy of the activation kernels.
+   */
+  void setAccuracy(KernelAccuracy _accuracy) {
+    accuracy = _accuracy;
+    if (compiled.get()) compiled->setAccuracy(accuracy);
+  }
+
+  /**
+   * Sets the precision used by the compiled network to evaluate, see
+   * Precision.
+   *
+   * @param _precision The precision of the weights, values and sums.
+   */
+  void setPrecision(Precision _precision) {
+    precision = _precision;
+    if (compiled.get()) compiled->setPrecision(precision);
+  }
+
+  /**
+   * Sets how findFixPoint feeds the outputs back to the inputs, see
+   * UpdateMode.
+   *
+   * @param _mode The update mode of the fixpoint iteration.
+   */
+  void setUpdateMode(UpdateMode _mode) { updateMode = _mode; }
+
+  /**
+   * Saves the current weights of every node as the best ones seen so far.
+   * When the network is compiled this is a single copy inside the weight arena
+   * of the plan, which holds the authoritative weights until they are written
+   * back with CompiledNetwork::writeBack.
+   */
+  void saveWeights();
+  /**
+   * Restores the weights saved by saveWeights.
+   */
+  void restoreWeights();
+
+  /**
+   * Getter of the compiled plan.
+   *
+   * @return a pointer to the compiled plan, empty if the network is not
+   * compiled.
+   */
+  CompiledNetworkPtr getCompiled() { return compiled; }
+
+  /**
+   * Evaluates the network with the inputs given by label. Each label of the
+   * map is looked up among the input ends, whose values are set, and the
+   * outputs are gathered by label into a new map, from the compiled plan if
+   * the network is compiled or recursively otherwise. The labels are the ones
+   * given by addNode, without the _i and _o suffixes of the nodes, e.g. the
+   * input node p_i of subnetwork 0 is set by w0-p. Inputs not present in
+   * the map keep the value they had in the previous evaluation, whether it
+   * was given by label or by port. For repeated evaluations
+   * evaluate(std::span, std::span) avoids the lookups and the maps.
+   *
+   * @see NeuralNetwork#evaluate(ParamsMap&)
+   */
   virtual ParamsMap evaluate(ParamsMap& input);
 
+  /**
+   * Computes the fixpoint feeding each output back to the input with the same
+   * label, e.g. the output of the node p_o to the input of the node p_i, both
+   * labelled w0-p. The network is compiled if needed and iterated by a
+   * RecurrentNetwork over buffers indexed by port, so the maps are only read
+   * and written once. The engine is kept between calls and only built again
+   * after the network is modified or compiled, or its compiled weights are
+   * reported changed. Inputs without an output keep their value, and inputs
+   * not present in the map keep the value they had in the previous
+   * evaluation. If the network can not be compiled the recursive evaluation of
+   * NeuralNetwork::findFixPoint is used.
+   *
+   * @see NeuralNetwork#findFixPoint
+   */
+  virtual ParamsMap findFixPoint(ParamsMap input, double tolerance = 0,
+                                 const FixPointBudget& budget = FixPointBudget(),
+                                 FixPointResult* result = NULL);
+
+  /**
+   * Returns the output port feeding each input port when the outputs are fed
+   * back to the inputs, i.e. the port of the output with the same label.
+   *
+   * @return One element per input port, the output port with its label or -1.
+   */
+  std::vector<int> feedbackPorts();
+
+  /**
+   * Resolves the label of an input end, e.g. w0-p, into its port, the index
+   * used for that input by evaluate(std::span, std::span). Ports are the
+   * position of the label among the sorted labels of the inputs, so they stay
+   * valid until an input is added to the network.
+   *
+   * @param label The label of the input end.
+   *
+   * @return The port of the input or -1 if there's no input with that label.
+   */
+  int inputPort(const std::string& label);
+  /**
+   * Resolves the label of an output end into its port.
+   *
+   * @see inputPort
+   *
+   * @param label The label of the output end.
+   *
+   * @return The port of the output or -1 if there's no output with that label.
+   */
+  int outputPort(const std::string& label);
+  /**
+   * Returns the number of input ends of the network.
+   *
+   * @return the number of input ports.
+   */
+  unsigned int noInputs() { return inputs.size(); }
+  /**
+   * Returns the number of output ends of the network.
+   *
+   * @return the number of output ports.
+   */
+  unsigned int noOutputs() { return outputs.size(); }
+
+  /**
+   * Evaluates the network reading the value of every input from a buffer
+   * indexed by input port and writes the value of every output in a buffer
+   * indexed by output port. No strings are compared and nothing is allocated
+   * once the network is compiled, which this method does the first time it
+   * is called. The values are also set on the input ends, so a later
+   * evaluation by label starts from them.
+   *
+   * @param input The value of each input port. It must contain noInputs()
+   * elements.
+   *
+   * @param output Buffer for the value of each output port. It must contain
+   * noOutputs() elements.
+   */
+  void evaluate(std::span<const double> input, std::span<double> output);
+
+  /**
+   * Evaluates a batch of input vectors in one call, compiling the network if
+   * it is not compiled yet.
+   *
+   * @see CompiledNetwork#evaluateBatch
+   *
+   * @param input Row major matrix with noInputs() values, indexed by input
+   * port, for each one of the rows.
+   *
+   * @param output Row major matrix with room for noOutputs() values, indexed by
+   * output port, for each one of the rows.
+   *
+   * @param rows The number of input vectors to evaluate.
+   */
+  void evaluateBatch(std::span<const double> input, std::span<double> output,
+                     unsigned int rows);
+
   /**
    * Returns a reference to the std::vector that represents the subnetwork i.
    *
@@ -131,10 +341,16 @@ class FeedForwardNeuralNetwork : public NeuralNetwork {
   unsigned int noSubNN() { return nodes.size(); }
 
   /**
-   * calls the reset value of all nodes in the network. Useful when more than
-   * one input is going to be evaluated.
+   * Invalidates the values computed by the nodes of the network so the next
+   * evaluation computes them again. Since all the nodes added to the network
+   * share its evaluation epoch, this only increases the epoch counter and does
+   * not visit the nodes.
+   *
+   * @remarks Nodes connected without going through the network (e.g. with
+   * NeuralConnection::connect) keep their own epoch and must be reset by
+   * hand.
    */
-  void reset();
+  void reset() { ++*epoch; }
 
 #ifdef DEBUG
   virtual std::string debugString();
@@ -0,0 +1,85 @@
+/**
+ * @file fixpoint.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "fixpoint.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace nalso {
+namespace neural {
+
+FixPointMonitor::FixPointMonitor(const FixPointBudget& _budget, double _tolerance)
+    : budget(_budget),
+      tolerance(_tolerance),
+      start(std::chrono::steady_clock::now()),
+      size(0) {
+  hashes.resize(budget.history);
+}
+
+uint64_t FixPointMonitor::hash(std::span<const double> state) {
+  // FNV-1a over the values
+  uint64_t res = 14695981039346656037ull;
+  for (unsigned int i = 0; i < state.size(); i++) {
+    double value = state[i];
+    // -0 and 0 are the same value
+    if (value == 0) value = 0;
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    res = (res ^ bits) * 1099511628211ull;
+  }
+  return res;
+}
+
+bool FixPointMonitor::proceed(std::span<const double> state) {
+  unsigned int iteration = result.iterations++;
+
+  if (budget.history) {
+    if (size != state.size()) {
+      size = state.size();
+      states.assign(budget.history * size, 0);
+    }
+
+    // the states of the last iterations, newest first. Values within the
+    // tolerance may fall either side of any rounding, so the hashes only skip
+    // rows when the states must be exactly equal
+    uint64_t code = tolerance > 0 ? 0 : hash(state);
+    unsigned int seen = std::min(iteration, budget.history);
+    for (unsigned int k = 1; k <= seen; k++) {
+      unsigned int row = (iteration - k) % budget.history;
+      if (tolerance == 0 && hashes[row] != code) continue;
+      const double* past = states.data() + row * size;
+      bool equal = true;
+      for (unsigned int i = 0; i < size && equal; i++) {
+        equal = std::fabs(past[i] - state[i]) <= tolerance;
+      }
+      if (equal) {
+        result.status = OSCILLATING_STATUS;
+        result.period = k;
+        return false;
+      }
+    }
+
+    unsigned int row = iteration % budget.history;
+    hashes[row] = code;
+    std::copy(state.begin(), state.end(), states.begin() + row * size);
+  }
+
+  bool exhausted = budget.maxIterations && result.iterations >= budget.maxIterations;
+  if (!exhausted && budget.maxSeconds > 0) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    exhausted = elapsed.count() >= budget.maxSeconds;
+  }
+  if (exhausted) {
+    result.status = EXHAUSTED_STATUS;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace neural
+}  // namespace nalso
@@ -0,0 +1,137 @@
+#pragma once
+/**
+ * @file fixpoint.hh
+ *
+ * @brief Budgets and outcomes of fixpoint iterations.
+ *
+ * Contains the limits given to the methods which iterate a network until it
+ * reaches a fixpoint, the description of how the iteration ended, and the
+ * monitor which enforces the limits and detects cycles.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nalso {
+namespace neural {
+
+/**
+ * How an iteration towards a fixpoint ended.
+ */
+enum FixPointStatus {
+  CONVERGED_STATUS = 0,    // two consecutive states were equal
+  OSCILLATING_STATUS = 1,  // a state seen some iterations before came back
+  EXHAUSTED_STATUS = 2     // the iterations or the time of the budget ran out
+};
+
+/**
+ * How the units of a network are updated by each iteration towards a
+ * fixpoint.
+ */
+enum UpdateMode {
+  SYNCHRONOUS_UPDATE = 0,  // every unit is computed from the previous state
+  ASYNCHRONOUS_UPDATE = 1  // each unit sees the units updated before it
+};
+
+/**
+ * @brief Limits of an iteration towards a fixpoint.
+ *
+ * Programs without a stable model, e.g. p :- not p, make the network move
+ * forever, so every iteration is bounded. A limit of 0 means no limit.
+ */
+struct FixPointBudget {
+  /** Default number of iterations, enough for networks of any sensible depth */
+  static const unsigned int DEFAULT_MAX_ITERATIONS = 100000;
+  /** Default number of past states remembered to detect cycles */
+  static const unsigned int DEFAULT_HISTORY = 16;
+
+  /** Largest number of iterations */
+  unsigned int maxIterations;
+  /** Largest wall clock time in seconds */
+  double maxSeconds;
+  /** Number of past states compared with each new one, which detects cycles
+   * of at most this length */
+  unsigned int history;
+
+  FixPointBudget(unsigned int _maxIterations = DEFAULT_MAX_ITERATIONS,
+                 double _maxSeconds = 0, unsigned int _history = DEFAULT_HISTORY)
+      : maxIterations(_maxIterations), maxSeconds(_maxSeconds), history(_history) {}
+};
+
+/**
+ * @brief The outcome of an iteration towards a fixpoint.
+ */
+struct FixPointResult {
+  FixPointStatus status;
+  /** Number of iterations run */
+  unsigned int iterations;
+  /** Length of the cycle found when oscillating, 0 otherwise */
+  unsigned int period;
+
+  FixPointResult() : status(CONVERGED_STATUS), iterations(0), period(0) {}
+};
+
+/**
+ * @brief Watches an iteration towards a fixpoint.
+ *
+ * The loop reports every state it reaches. The monitor counts them, checks the
+ * budget and keeps the last states in a ring. Without a tolerance a hash of
+ * each state is kept too, so a new state is only compared value by value with
+ * the past states of the same hash. With a tolerance two states are equal when
+ * no value differs by more than the tolerance, as in
+ * NeuralNetwork::areEqualParameters, and the new state is compared with every
+ * state of the ring.
+ */
+class FixPointMonitor {
+ private:
+  FixPointBudget budget;
+  double tolerance;
+  std::chrono::steady_clock::time_point start;
+  FixPointResult result;
+
+  /** Ring of the last states, budget.history rows of size values each */
+  std::vector<double> states;
+  std::vector<uint64_t> hashes;
+  unsigned int size;
+
+  /**
+   * Hashes a state, where 0 and -0 are the same value.
+   */
+  uint64_t hash(std::span<const double> state);
+
+ public:
+  /**
+   * Starts watching an iteration, the clock of the budget starts now.
+   *
+   * @param _budget The limits of the iteration.
+   *
+   * @param _tolerance The largest difference between two equal values.
+   */
+  FixPointMonitor(const FixPointBudget& _budget, double _tolerance = 0);
+
+  /**
+   * Records the state reached by one more iteration which did not converge.
+   *
+   * @param state The values of the state.
+   *
+   * @return true if the iteration may go on, false if the state closes a cycle
+   * or the budget ran out, which getResult tells apart.
+   */
+  bool proceed(std::span<const double> state);
+  /**
+   * Records one more iteration whose state is equal to the previous one.
+   */
+  void converged() {
+    result.iterations++;
+    result.status = CONVERGED_STATUS;
+  }
+
+  FixPointResult getResult() { return result; }
+};
+
+}  // namespace neural
+}  // namespace nalso
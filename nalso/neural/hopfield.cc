@@ -7,6 +7,8 @@
 
 #include "hopfield.hh"
 
+#include "nalso/neural/compiledhopfield.hh"
+
 namespace nalso {
 namespace neural {
 
@@ -36,6 +38,7 @@ void HopfieldNeuralNetwork::connectNodes(std::vector<HopfieldNodePtr> _nodes,
 #ifdef DEBUG
   connections.push_back(make_pair(weight, _nodes));
 #endif
+  compiled.reset();
   HyperConnectionPtr conn(new HyperConnection);
   (*conn).first = weight;
   for (unsigned int i = 0; i < _nodes.size(); i++) {
@@ -55,6 +58,36 @@ void HopfieldNeuralNetwork::connectNodes(std::vector<std::string> _nodeNames,
   connectNodes(_nodes, weight);
 }
 
+bool HopfieldNeuralNetwork::compile() {
+  compiled = CompiledHopfield::compile(nodes, coolingFactor);
+  if (!compiled.get()) return false;
+  compiled->setAccuracy(accuracy);
+  compiled->setPrecision(precision);
+  compiled->setThreadPool(pool);
+  compiled->setUpdateMode(updateMode);
+  return true;
+}
+
+void HopfieldNeuralNetwork::setAccuracy(KernelAccuracy _accuracy) {
+  accuracy = _accuracy;
+  if (compiled.get()) compiled->setAccuracy(accuracy);
+}
+
+void HopfieldNeuralNetwork::setPrecision(Precision _precision) {
+  precision = _precision;
+  if (compiled.get()) compiled->setPrecision(precision);
+}
+
+void HopfieldNeuralNetwork::setThreadPool(utils::ThreadPoolPtr _pool) {
+  pool = _pool;
+  if (compiled.get()) compiled->setThreadPool(pool);
+}
+
+void HopfieldNeuralNetwork::setUpdateMode(UpdateMode _mode) {
+  updateMode = _mode;
+  if (compiled.get()) compiled->setUpdateMode(updateMode);
+}
+
 ParamsMap HopfieldNeuralNetwork::evaluate(ParamsMap& input) {
   for (auto it = input.begin(); it != input.end(); it++) {
     if (nodes.find((*it).first) != nodes.end()) {
@@ -70,7 +103,9 @@ ParamsMap HopfieldNeuralNetwork::evaluate(ParamsMap& input) {
 }
 
 ParamsMap HopfieldNeuralNetwork::findFixPoint(ParamsMap input,
-                                              double tolerance /* = 0*/) {
+                                              double tolerance /* = 0*/,
+                                              const FixPointBudget& budget,
+                                              FixPointResult* result) {
   // first set the inputs as the initial potential set.
   for (auto it = input.begin(); it != input.end(); it++) {
     if (nodes.find((*it).first) != nodes.end()) {
@@ -79,14 +114,26 @@ ParamsMap HopfieldNeuralNetwork::findFixPoint(ParamsMap input,
   }
 
   ParamsMap outOld, outNew;
+  if (compiled.get() || compile()) {
+    FixPointResult res = compiled->findFixPoint(tolerance, budget);
+    unsigned int index = 0;
+    for (auto nit = nodes.begin(); nit != nodes.end(); nit++, index++) {
+      outNew.insert(make_pair((*nit).first, compiled->getOutput(index)));
+    }
+    if (result) *result = res;
+    return outNew;
+  }
+
+  // the network can not be compiled, the nodes are iterated
   // evaluate the network with the initial potential
   for (auto nit = nodes.begin(); nit != nodes.end(); nit++) {
     outNew.insert(make_pair((*nit).first, (*(*nit).second).outputValue()));
   }
 
-  do {
-    outOld = outNew;  // the new becomes old
-    outNew.clear();
+  FixPointMonitor monitor(budget, tolerance);
+  std::vector<double> state;
+  while (true) {
+    outOld.swap(outNew);  // the new becomes old
 
     // compute the next potential value
     for (auto nit = nodes.begin(); nit != nodes.end(); nit++) {
@@ -98,12 +145,23 @@ ParamsMap HopfieldNeuralNetwork::findFixPoint(ParamsMap input,
       (*(*nit).second).updatePotential();
     }
 
-    // evaluate the network with the new potential
+    // evaluate the network with the new potential, the keys do not change so
+    // the values are overwritten in place
+    state.clear();
     for (auto nit = nodes.begin(); nit != nodes.end(); nit++) {
-      outNew.insert(make_pair((*nit).first, (*(*nit).second).outputValue()));
+      double value = (*(*nit).second).outputValue();
+      outNew[(*nit).first] = value;
+      state.push_back(value);
+    }
+
+    if (NeuralNetwork::areEqualParameters(outNew, outOld, tolerance)) {
+      monitor.converged();
+      break;
     }
-  } while (!NeuralNetwork::areEqualParameters(outNew, outOld, tolerance));
+    if (!monitor.proceed(state)) break;
+  }
 
+  if (result) *result = monitor.getResult();
   return outNew;
 }
 
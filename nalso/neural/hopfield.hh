@@ -9,7 +9,10 @@
  * @author Alexander Rojas <alexander.rojas@gmail.com>
  */
 
+#include "nalso/neural/compiled.hh"
+#include "nalso/neural/kernels.hh"
 #include "nalso/neural/neuralnetwork.hh"
+#include "nalso/utils/threadpool.hh"
 
 #include <cmath>
 #include <list>
@@ -21,6 +24,8 @@ namespace neural {
 
 class HopfieldNode;
 typedef std::shared_ptr<HopfieldNode> HopfieldNodePtr;
+class CompiledHopfield;
+typedef std::shared_ptr<CompiledHopfield> CompiledHopfieldPtr;
 
 /**
  * A hyper connection is a pair (doube, list of nodes) whose first parameter is
@@ -152,6 +157,7 @@ class HopfieldNode {
    */
   double getPotential() { return potential; }
   std::string getId() { return id; }
+  const std::list<HyperConnectionPtr>& getInputs() { return inputs; }
   std::shared_ptr<double> getCoolingFactor() { return coolingFactor; }
   void setCoolingFactor(std::shared_ptr<double> _factor) { coolingFactor = _factor; }
 };
@@ -173,10 +179,18 @@ class HopfieldNeuralNetwork : public NeuralNetwork {
 #endif
   std::map<std::string, HopfieldNodePtr> nodes;
   std::shared_ptr<double> coolingFactor;
+  CompiledHopfieldPtr compiled;
+  KernelAccuracy accuracy;
+  Precision precision;
+  utils::ThreadPoolPtr pool;
+  UpdateMode updateMode;
 
  public:
   HopfieldNeuralNetwork(double initCool = 1)
-      : coolingFactor(new double(initCool)) {};
+      : coolingFactor(new double(initCool)),
+        accuracy(EXACT_ACCURACY),
+        precision(DOUBLE_PRECISION),
+        updateMode(SYNCHRONOUS_UPDATE) {};
 
   /**
    * Adds a node to the network and sets its cooling factor pointer.
@@ -184,6 +198,7 @@ class HopfieldNeuralNetwork : public NeuralNetwork {
    * @param _node the node to be added.
    */
   void addNode(HopfieldNodePtr _node) {
+    compiled.reset();
     (*_node).setCoolingFactor(coolingFactor);
     nodes.insert(make_pair((*_node).getId(), _node));
   }
@@ -211,9 +226,66 @@ class HopfieldNeuralNetwork : public NeuralNetwork {
    */
   void connectNodes(std::vector<std::string> _nodeNames, double weight = 1);
 
+  /**
+   * Flattens the nodes and hyperedges of the network into a CompiledHopfield,
+   * which findFixPoint iterates instead of the nodes. findFixPoint compiles
+   * the network itself when needed, and connecting nodes through the network
+   * discards the compiled one, but hyperedges added directly on the nodes are
+   * not seen until compile is called again.
+   *
+   * @return true if the network was compiled, false if a hyperedge contains a
+   * node which was not added to the network, in which case findFixPoint
+   * iterates the nodes.
+   */
+  bool compile();
+
+  /**
+   * Getter of the compiled network.
+   *
+   * @return a pointer to the compiled network, empty if the network is not
+   * compiled.
+   */
+  CompiledHopfieldPtr getCompiled() { return compiled; }
+
+  /**
+   * Sets how the compiled network computes the outputs of the nodes, see
+   * CompiledHopfield::setAccuracy.
+   *
+   * @param _accuracy The accuracy of the outputs.
+   */
+  void setAccuracy(KernelAccuracy _accuracy);
+
+  /**
+   * Sets the precision of the products computed by the compiled network, see
+   * CompiledHopfield::setPrecision.
+   *
+   * @param _precision The precision of the weights, outputs and terms.
+   */
+  void setPrecision(Precision _precision);
+
+  /**
+   * Sets the thread pool the sweeps of findFixPoint are split across, see
+   * CompiledHopfield.
+   *
+   * @param _pool The pool to use, an empty pointer to sweep in the calling
+   * thread only.
+   */
+  void setThreadPool(utils::ThreadPoolPtr _pool);
+
+  /**
+   * Sets whether findFixPoint updates all the nodes at once or a colour of
+   * nodes at a time, see CompiledHopfield. A network which can not be
+   * compiled is always updated at once.
+   *
+   * @param _mode The update mode.
+   */
+  void setUpdateMode(UpdateMode _mode);
+
   virtual ParamsMap evaluate(ParamsMap& input);
 
-  virtual ParamsMap findFixPoint(ParamsMap input, double tolerance = 0);
+  virtual ParamsMap findFixPoint(ParamsMap input, double tolerance = 0,
+                                 const FixPointBudget& budget = FixPointBudget(),
+                                 FixPointResult* result = NULL);
 
   void setCooling(double cooling) { *coolingFactor = cooling; }
   double getCooling() { return *coolingFactor; }
@@ -0,0 +1,163 @@
+/**
+ * @file incremental.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "incremental.hh"
+
+#include <algorithm>
+#include <functional>
+
+#include "nalso/neural/kernels.hh"
+
+namespace nalso {
+namespace neural {
+
+IncrementalNetworkPtr IncrementalNetwork::compile(CompiledNetworkPtr _network) {
+  IncrementalNetworkPtr res(new IncrementalNetwork);
+  CompiledNetwork& net = *_network;
+  unsigned int nodes = net.noNodes();
+  unsigned int slots = net.leaves.size() + nodes;
+  const double* weights = net.section(CompiledNetwork::WEIGHTS);
+
+  res->network = _network;
+
+  // the connections leaving each slot, counted first to lay them out by slot
+  res->fanStart.assign(slots + 1, 0);
+  for (unsigned int e = 0; e < net.column.size(); e++) res->fanStart[net.column[e] + 1]++;
+  for (unsigned int s = 0; s < slots; s++) res->fanStart[s + 1] += res->fanStart[s];
+  res->fanNode.resize(res->fanStart.back());
+  res->fanWeight.resize(res->fanStart.back());
+  std::vector<unsigned int> fill(res->fanStart.begin(), res->fanStart.end() - 1);
+
+  for (unsigned int n = 0; n < nodes; n++) {
+    const double* block = weights + net.weightOffset[n];
+    res->bias.push_back(block[0]);
+    for (unsigned int e = net.rowStart[n], k = 1; e < net.rowStart[n + 1]; e++, k++) {
+      unsigned int slot = net.column[e];
+      res->fanNode[fill[slot]] = n;
+      res->fanWeight[fill[slot]++] = block[k];
+    }
+  }
+
+  res->values.resize(slots);
+  res->sums.resize(nodes);
+  res->queued.resize(nodes);
+  res->pending.reserve(nodes);
+  return res;
+}
+
+double IncrementalNetwork::activate(unsigned int node) {
+  CompiledNetwork& net = *network;
+  double value = sums[node];
+  switch (net.kind[node]) {
+    case SIGMOID_ACTIVATION:
+      kernels::sigmoid(&value, 1, net.accuracy);
+      return value;
+    case BIPOLAR_ACTIVATION:
+      kernels::bipolar(&value, 1, net.beta[node], net.accuracy);
+      return value;
+    case STEP_ACTIVATION:
+      return value >= bias[node] ? 1 : 0;
+    default:
+      return value;
+  }
+}
+
+void IncrementalNetwork::evaluateAll(std::span<const double> input) {
+  CompiledNetwork& net = *network;
+  unsigned int base = net.leaves.size();
+  std::copy_n(input.begin(), net.numInputs, values.begin());
+  for (unsigned int i = net.numInputs; i < base; i++) {
+    values[i] = net.leaves[i]->outputValue(true);
+  }
+
+  for (unsigned int n = 0; n < sums.size(); n++) {
+    // the threshold of a step node is compared with the sum instead
+    sums[n] = net.kind[n] == STEP_ACTIVATION ? 0 : bias[n];
+  }
+  // the nodes are in evaluation order, so a node is complete once the slots
+  // before it have pushed their values
+  for (unsigned int s = 0; s < values.size(); s++) {
+    if (s >= base) values[s] = activate(s - base);
+    for (unsigned int e = fanStart[s]; e < fanStart[s + 1]; e++) {
+      sums[fanNode[e]] += values[s] * fanWeight[e];
+    }
+  }
+  updated = sums.size();
+}
+
+void IncrementalNetwork::push(unsigned int slot, double change) {
+  for (unsigned int e = fanStart[slot]; e < fanStart[slot + 1]; e++) {
+    unsigned int node = fanNode[e];
+    sums[node] += change * fanWeight[e];
+    if (!queued[node]) {
+      queued[node] = 1;
+      pending.push_back(node);
+      std::push_heap(pending.begin(), pending.end(), std::greater<unsigned int>());
+    }
+  }
+}
+
+void IncrementalNetwork::propagate() {
+  unsigned int base = network->leaves.size();
+  // the nodes only read nodes before them, so taking the first pending node
+  // every time visits each one after all of its inputs settled
+  while (!pending.empty()) {
+    std::pop_heap(pending.begin(), pending.end(), std::greater<unsigned int>());
+    unsigned int node = pending.back();
+    pending.pop_back();
+    queued[node] = 0;
+    updated++;
+
+    double value = activate(node);
+    if (value == values[base + node]) continue;
+    double change = value - values[base + node];
+    values[base + node] = value;
+    push(base + node, change);
+  }
+}
+
+void IncrementalNetwork::evaluate(std::span<const double> input,
+                                  std::span<double> output) {
+  CompiledNetwork& net = *network;
+
+  if (calls == 0) {
+    evaluateAll(input);
+  } else {
+    updated = 0;
+    for (unsigned int i = 0; i < net.numInputs; i++) {
+      if (input[i] == values[i]) continue;
+      double change = input[i] - values[i];
+      values[i] = input[i];
+      push(i, change);
+    }
+    propagate();
+  }
+  calls = (calls + 1) % RESYNC_INTERVAL;
+
+  for (unsigned int o = 0; o < net.outputSource.size(); o++) {
+    output[o] = outputValue(o);
+  }
+}
+
+void IncrementalNetwork::setInput(unsigned int port, double value) {
+  if (calls == 0) {
+    std::vector<double> input(values.begin(), values.begin() + network->numInputs);
+    input[port] = value;
+    evaluateAll(input);
+  } else {
+    updated = 0;
+    if (value != values[port]) {
+      double change = value - values[port];
+      values[port] = value;
+      push(port, change);
+      propagate();
+    }
+  }
+  calls = (calls + 1) % RESYNC_INTERVAL;
+}
+
+}  // namespace neural
+}  // namespace nalso
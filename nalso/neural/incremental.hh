@@ -0,0 +1,158 @@
+#pragma once
+/**
+ * @file incremental.hh
+ *
+ * @brief Evaluation of a compiled network driven by the changes of its inputs.
+ *
+ * Contains the declaration of an evaluator which keeps the weighted sums of
+ * the last evaluation and only recomputes the nodes reached by the inputs
+ * which changed since then.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "nalso/neural/compiled.hh"
+
+namespace nalso {
+namespace neural {
+
+/**
+ * @brief A compiled network evaluated by propagating changes.
+ *
+ * The evaluator keeps the value and the weighted sum of every node from the
+ * previous call. When an input changes, its change times the weight of each
+ * connection leaving it is added to the sums of the nodes reading it, and
+ * those nodes are recomputed in the order of the plan. A node whose value does
+ * not change stops the propagation, so the cost of an evaluation grows with
+ * the number of nodes whose inputs moved instead of with the size of the
+ * network, which suits fixpoint iterations and what-if queries changing a few
+ * inputs at a time.
+ *
+ * The sums are computed from scratch on the first call, after reset and every
+ * RESYNC_INTERVAL calls, so the rounding errors of the updates do not build
+ * up. The values may then differ from those of CompiledNetwork::evaluate in
+ * the last bits. The weights and the values of the ends which are not inputs
+ * are read when the evaluator is built, so it has to be built again after
+ * training.
+ */
+class IncrementalNetwork {
+ public:
+  /** Calls between two evaluations from scratch */
+  static const unsigned int RESYNC_INTERVAL = 4096;
+
+ private:
+  CompiledNetworkPtr network;
+
+  /**
+   * The slot s is read by the node fanNode[e] with the weight fanWeight[e], for
+   * e in [fanStart[s], fanStart[s + 1]).
+   */
+  std::vector<unsigned int> fanStart;
+  std::vector<unsigned int> fanNode;
+  std::vector<double> fanWeight;
+
+  /** Bias of each node, the threshold for step nodes */
+  std::vector<double> bias;
+
+  /** Value of every slot and weighted sum of every node, bias included
+   * except for step nodes */
+  std::vector<double> values;
+  std::vector<double> sums;
+  /** Nodes whose sum moved, as a heap ordered by position in the plan */
+  std::vector<unsigned int> pending;
+  std::vector<unsigned char> queued;
+
+  /** Calls since the sums were computed from scratch, 0 if they never were */
+  unsigned int calls;
+  /** Nodes recomputed by the last call */
+  unsigned int updated;
+
+  IncrementalNetwork() : calls(0), updated(0) {}
+
+  /**
+   * Computes the sum and value of every node from scratch.
+   */
+  void evaluateAll(std::span<const double> input);
+  /**
+   * Adds the change of the value of a slot to the nodes reading it.
+   */
+  void push(unsigned int slot, double change);
+  /**
+   * Recomputes the pending nodes until no value changes.
+   */
+  void propagate();
+  /**
+   * Applies the activation of a node to its sum.
+   */
+  double activate(unsigned int node);
+
+ public:
+  /**
+   * Builds the incremental evaluator of a compiled network.
+   *
+   * @param _network The compiled network.
+   *
+   * @return A pointer to the evaluator.
+   */
+  static std::shared_ptr<IncrementalNetwork> compile(CompiledNetworkPtr _network);
+
+  /**
+   * Computes the outputs of the network for the given inputs, only
+   * recomputing the nodes affected by the inputs which differ from the
+   * previous call.
+   *
+   * @param input The value of each input, indexed by input port.
+   *
+   * @param output Buffer where the value of each output, indexed by output
+   * port, is written.
+   */
+  void evaluate(std::span<const double> input, std::span<double> output);
+
+  /**
+   * Changes the value of a single input and recomputes the nodes it reaches,
+   * e.g. to feed the new value of an atom back before computing the next one.
+   * The other inputs keep the value of the previous call, 0 if there was none.
+   *
+   * @param port The input port.
+   *
+   * @param value The new value of the input.
+   */
+  void setInput(unsigned int port, double value);
+
+  /**
+   * Returns the value of an output after the last call to evaluate or
+   * setInput.
+   *
+   * @param index The output port.
+   *
+   * @return The value of the output.
+   */
+  double outputValue(unsigned int index) {
+    int source = network->outputSource[index];
+    return source < 0 ? 0 : values[source];
+  }
+
+  /**
+   * Forgets the sums kept from the previous call, so the next one computes
+   * every node.
+   */
+  void reset() { calls = 0; }
+
+  /**
+   * Returns the number of nodes recomputed by the last call to evaluate or
+   * setInput.
+   *
+   * @return The number of nodes whose activation was applied.
+   */
+  unsigned int noUpdated() { return updated; }
+  CompiledNetworkPtr getNetwork() { return network; }
+};
+
+typedef std::shared_ptr<IncrementalNetwork> IncrementalNetworkPtr;
+
+}  // namespace neural
+}  // namespace nalso
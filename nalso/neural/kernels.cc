@@ -0,0 +1,297 @@
+/**
+ * @file kernels.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "kernels.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NALSO_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace nalso {
+namespace neural {
+namespace kernels {
+
+namespace {
+
+const double LOW = -45;
+const double HIGH = 45;
+
+/** Arguments of exp beyond this bound would overflow the scale 2^n */
+const double EXP_LIMIT = 708;
+const double LOG2E = 1.4426950408889634074;
+/** ln 2 split in two parts so that n * LN2_HI is exact */
+const double LN2_HI = 6.93147180369123816490e-01;
+const double LN2_LO = 1.90821492927058770002e-10;
+/** Magic number whose addition leaves an integer in the low mantissa bits */
+const double ROUND_BITS = 6755399441055744.0;
+/** Taylor coefficients of exp, 1 / k! */
+const double C2 = 1.0 / 2;
+const double C3 = 1.0 / 6;
+const double C4 = 1.0 / 24;
+const double C5 = 1.0 / 120;
+const double C6 = 1.0 / 720;
+const double C7 = 1.0 / 5040;
+
+std::atomic<int> selected(-1);
+
+/**
+ * Scalar version of the approximate exponential used by the SIMD kernels.
+ */
+inline double fastExp(double x) {
+  if (std::isnan(x)) return x;
+  x = std::min(std::max(x, -EXP_LIMIT), EXP_LIMIT);
+  double n = std::nearbyint(x * LOG2E);
+  double r = (x - n * LN2_HI) - n * LN2_LO;
+  double p = 1 + r * (1 + r * (C2 + r * (C3 + r * (C4 + r * (C5 + r * (C6 + r * C7))))));
+  uint64_t bits = (uint64_t)((int64_t)n + 1023) << 52;
+  double scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+}
+
+inline double fastSigmoid(double value) {
+  if (value < LOW) return 0;
+  if (value > HIGH) return 1;
+  return 1 / (1 + fastExp(-value));
+}
+
+inline double fastBipolar(double value, double beta) {
+  if (value < LOW) return -1;
+  if (value > HIGH) return 1;
+  return (2 / (1 + fastExp(-beta * value))) - 1;
+}
+
+void sigmoidScalar(double* values, unsigned int count) {
+  for (unsigned int i = 0; i < count; i++) values[i] = fastSigmoid(values[i]);
+}
+
+void bipolarScalar(double* values, unsigned int count, double beta) {
+  for (unsigned int i = 0; i < count; i++) values[i] = fastBipolar(values[i], beta);
+}
+
+#ifdef NALSO_X86_KERNELS
+
+__attribute__((target("avx2,fma"))) inline __m256d exp4(__m256d x) {
+  // the bounds go first so NaN propagates
+  x = _mm256_min_pd(_mm256_set1_pd(EXP_LIMIT),
+                    _mm256_max_pd(_mm256_set1_pd(-EXP_LIMIT), x));
+  __m256d n = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(LOG2E)),
+                              _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256d r = _mm256_fnmadd_pd(n, _mm256_set1_pd(LN2_HI), x);
+  r = _mm256_fnmadd_pd(n, _mm256_set1_pd(LN2_LO), r);
+
+  __m256d p = _mm256_fmadd_pd(_mm256_set1_pd(C7), r, _mm256_set1_pd(C6));
+  p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(C5));
+  p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(C4));
+  p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(C3));
+  p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(C2));
+  p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1));
+  p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1));
+
+  // AVX2 can not convert doubles to 64 bit integers, so 2^n is built from
+  // the integer left in the mantissa by adding ROUND_BITS
+  __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(ROUND_BITS)));
+  bits = _mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+  return _mm256_mul_pd(p, _mm256_castsi256_pd(bits));
+}
+
+/**
+ * Computes 1 / (1 + exp(-scale * v)).
+ */
+__attribute__((target("avx2,fma"))) inline __m256d logistic4(__m256d v,
+                                                            __m256d scale) {
+  const __m256d one = _mm256_set1_pd(1);
+  __m256d e = exp4(_mm256_mul_pd(_mm256_sub_pd(_mm256_setzero_pd(), scale), v));
+  return _mm256_div_pd(one, _mm256_add_pd(one, e));
+}
+
+__attribute__((target("avx2,fma"))) inline __m256d clamp4(__m256d v, __m256d s,
+                                                         __m256d low) {
+  s = _mm256_blendv_pd(s, low,
+                       _mm256_cmp_pd(v, _mm256_set1_pd(LOW), _CMP_LT_OQ));
+  return _mm256_blendv_pd(s, _mm256_set1_pd(1),
+                          _mm256_cmp_pd(v, _mm256_set1_pd(HIGH), _CMP_GT_OQ));
+}
+
+__attribute__((target("avx2,fma"))) void sigmoidAvx2(double* values,
+                                                     unsigned int count) {
+  const __m256d one = _mm256_set1_pd(1);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d v = _mm256_loadu_pd(values + i);
+    _mm256_storeu_pd(values + i, clamp4(v, logistic4(v, one), _mm256_setzero_pd()));
+  }
+  sigmoidScalar(values + i, count - i);
+}
+
+__attribute__((target("avx2,fma"))) void bipolarAvx2(double* values,
+                                                     unsigned int count,
+                                                     double beta) {
+  const __m256d one = _mm256_set1_pd(1), two = _mm256_set1_pd(2);
+  const __m256d b = _mm256_set1_pd(beta);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d v = _mm256_loadu_pd(values + i);
+    __m256d s = _mm256_fmsub_pd(two, logistic4(v, b), one);
+    _mm256_storeu_pd(values + i, clamp4(v, s, _mm256_set1_pd(-1)));
+  }
+  bipolarScalar(values + i, count - i, beta);
+}
+
+// the AVX-512 intrinsics of GCC 12 trigger spurious uninitialised warnings
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f"))) inline __m512d exp8(__m512d x) {
+  x = _mm512_min_pd(_mm512_set1_pd(EXP_LIMIT),
+                    _mm512_max_pd(_mm512_set1_pd(-EXP_LIMIT), x));
+  __m512d n = _mm512_roundscale_pd(_mm512_mul_pd(x, _mm512_set1_pd(LOG2E)),
+                                   _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m512d r = _mm512_fnmadd_pd(n, _mm512_set1_pd(LN2_HI), x);
+  r = _mm512_fnmadd_pd(n, _mm512_set1_pd(LN2_LO), r);
+
+  __m512d p = _mm512_fmadd_pd(_mm512_set1_pd(C7), r, _mm512_set1_pd(C6));
+  p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(C5));
+  p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(C4));
+  p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(C3));
+  p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(C2));
+  p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1));
+  p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1));
+  return _mm512_scalef_pd(p, n);
+}
+
+__attribute__((target("avx512f"))) inline __m512d logistic8(__m512d v,
+                                                           __m512d scale) {
+  const __m512d one = _mm512_set1_pd(1);
+  __m512d e = exp8(_mm512_mul_pd(_mm512_sub_pd(_mm512_setzero_pd(), scale), v));
+  return _mm512_div_pd(one, _mm512_add_pd(one, e));
+}
+
+__attribute__((target("avx512f"))) inline __m512d clamp8(__m512d v, __m512d s,
+                                                        __m512d low) {
+  s = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(v, _mm512_set1_pd(LOW), _CMP_LT_OQ),
+                           s, low);
+  return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(v, _mm512_set1_pd(HIGH), _CMP_GT_OQ),
+                              s, _mm512_set1_pd(1));
+}
+
+/** Mask of the elements of the last, partial, vector of an array */
+inline __mmask8 tailMask(unsigned int remaining) {
+  return (__mmask8)((1u << std::min(remaining, 8u)) - 1);
+}
+
+__attribute__((target("avx512f"))) void sigmoidAvx512(double* values,
+                                                      unsigned int count) {
+  const __m512d one = _mm512_set1_pd(1);
+  for (unsigned int i = 0; i < count; i += 8) {
+    __mmask8 mask = tailMask(count - i);
+    __m512d v = _mm512_maskz_loadu_pd(mask, values + i);
+    _mm512_mask_storeu_pd(values + i, mask,
+                          clamp8(v, logistic8(v, one), _mm512_setzero_pd()));
+  }
+}
+
+__attribute__((target("avx512f"))) void bipolarAvx512(double* values,
+                                                      unsigned int count,
+                                                      double beta) {
+  const __m512d one = _mm512_set1_pd(1), two = _mm512_set1_pd(2);
+  const __m512d b = _mm512_set1_pd(beta);
+  for (unsigned int i = 0; i < count; i += 8) {
+    __mmask8 mask = tailMask(count - i);
+    __m512d v = _mm512_maskz_loadu_pd(mask, values + i);
+    __m512d s = _mm512_fmsub_pd(two, logistic8(v, b), one);
+    _mm512_mask_storeu_pd(values + i, mask, clamp8(v, s, _mm512_set1_pd(-1)));
+  }
+}
+
+#pragma GCC diagnostic pop
+
+#endif  // NALSO_X86_KERNELS
+
+}  // namespace
+
+KernelIsa bestIsa() {
+#ifdef NALSO_X86_KERNELS
+  if (__builtin_cpu_supports("avx512f")) return AVX512_ISA;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return AVX2_ISA;
+  }
+#endif
+  return SCALAR_ISA;
+}
+
+KernelIsa getIsa() {
+  int isa = selected.load(std::memory_order_relaxed);
+  if (isa < 0) {
+    isa = bestIsa();
+    selected.store(isa, std::memory_order_relaxed);
+  }
+  return (KernelIsa)isa;
+}
+
+bool setIsa(KernelIsa isa) {
+  if (isa > bestIsa()) return false;
+  selected.store(isa, std::memory_order_relaxed);
+  return true;
+}
+
+void sigmoid(double* values, unsigned int count, KernelAccuracy accuracy) {
+  if (accuracy == EXACT_ACCURACY) {
+    for (unsigned int i = 0; i < count; i++) {
+      double value = values[i];
+      values[i] = value < LOW ? 0 : value > HIGH ? 1 : 1 / (1 + std::exp(-value));
+    }
+    return;
+  }
+  switch (getIsa()) {
+#ifdef NALSO_X86_KERNELS
+    case AVX512_ISA:
+      sigmoidAvx512(values, count);
+      break;
+    case AVX2_ISA:
+      sigmoidAvx2(values, count);
+      break;
+#endif
+    default:
+      sigmoidScalar(values, count);
+  }
+}
+
+void bipolar(double* values, unsigned int count, double beta,
+             KernelAccuracy accuracy) {
+  if (accuracy == EXACT_ACCURACY) {
+    for (unsigned int i = 0; i < count; i++) {
+      double value = values[i];
+      values[i] = value < LOW    ? -1
+                  : value > HIGH ? 1
+                                 : (2 / (1 + std::exp(-beta * value))) - 1;
+    }
+    return;
+  }
+  switch (getIsa()) {
+#ifdef NALSO_X86_KERNELS
+    case AVX512_ISA:
+      bipolarAvx512(values, count, beta);
+      break;
+    case AVX2_ISA:
+      bipolarAvx2(values, count, beta);
+      break;
+#endif
+    default:
+      bipolarScalar(values, count, beta);
+  }
+}
+
+}  // namespace kernels
+}  // namespace neural
+}  // namespace nalso
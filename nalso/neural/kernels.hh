@@ -0,0 +1,90 @@
+#pragma once
+/**
+ * @file kernels.hh
+ *
+ * @brief Activation functions applied over whole arrays.
+ *
+ * Contains the declaration of the kernels which apply the sigmoid and bipolar
+ * semilinear functions to arrays of weighted sums, using AVX-512 or AVX2 when
+ * the processor supports them and plain C++ otherwise.
+ *
+ * @date Oct 16, 2026
+ */
+
+namespace nalso {
+namespace neural {
+
+/**
+ * Instruction sets the kernels are written for.
+ */
+enum KernelIsa { SCALAR_ISA = 0, AVX2_ISA = 1, AVX512_ISA = 2 };
+
+/**
+ * How the exponential of the sigmoid and bipolar kernels is computed.
+ *
+ * EXACT_ACCURACY calls std::exp for every element, so the results are the
+ * same as those of SigmoidMethod and BipolarSemilinearMethod.
+ *
+ * FAST_ACCURACY computes the exponential in SIMD registers with a range
+ * reduction to [-ln 2 / 2, ln 2 / 2] followed by the degree 7 Taylor
+ * polynomial, whose relative error is below 8e-9. The absolute error of the
+ * sigmoid is then below 2e-9 and the one of the bipolar function below 4e-9.
+ */
+enum KernelAccuracy { EXACT_ACCURACY = 0, FAST_ACCURACY = 1 };
+
+namespace kernels {
+
+/**
+ * Returns the best instruction set supported by the processor.
+ *
+ * @return The instruction set used by default.
+ */
+KernelIsa bestIsa();
+/**
+ * Returns the instruction set used by the kernels.
+ *
+ * @return The instruction set in use.
+ */
+KernelIsa getIsa();
+/**
+ * Selects the instruction set used by the kernels, e.g. to compare them.
+ *
+ * @param isa The instruction set to use.
+ *
+ * @return false if the processor does not support it, in which case the
+ * selection does not change.
+ */
+bool setIsa(KernelIsa isa);
+
+/**
+ * Applies the sigmoid function to an array of weighted sums. Sums below -45
+ * become 0 and sums above 45 become 1, as in SigmoidMethod.
+ *
+ * @param values The sums, replaced by the activations.
+ *
+ * @param count The number of values.
+ *
+ * @param accuracy How the exponential is computed.
+ */
+void sigmoid(double* values, unsigned int count, KernelAccuracy accuracy);
+
+/**
+ * Applies the bipolar semilinear function to an array of weighted sums. Sums
+ * below -45 become -1 and sums above 45 become 1, as in
+ * BipolarSemilinearMethod.
+ *
+ * @param values The sums, replaced by the activations.
+ *
+ * @param count The number of values.
+ *
+ * @param beta The steepness of the function.
+ *
+ * @param accuracy How the exponential is computed.
+ */
+void bipolar(double* values, unsigned int count, double beta,
+             KernelAccuracy accuracy);
+
+}  // namespace kernels
+
+}  // namespace neural
+}  // namespace nalso
@@ -13,6 +13,27 @@
 namespace nalso {
 namespace neural {
 
+void NeuralMethod::updateWeights(NeuralNode& node, double learn,
+                                 double momentum) {
+  std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
+  std::vector<double>& cWeights = node.getChangeInWeights();
+  std::vector<double>& weights = node.getWeights();
+
+  double learnTimesError = learn * node.errorValue(false);
+
+  double c = learnTimesError + momentum * cWeights[0];
+  weights[0] += c;
+  cWeights[0] = c;
+
+  for (unsigned int i = 1; i < inputs.size() + 1; i++) {
+    c = learnTimesError * inputs[i - 1]->outputValue(false);
+    c += momentum * cWeights[i];
+
+    weights[i] += c;
+    cWeights[i] = c;
+  }
+}
+
 double LinearMethod::outputValue(NeuralNode& node) {
   std::vector<double>& weights = node.getWeights();
   std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
@@ -35,27 +56,6 @@ double LinearMethod::errorValue(NeuralNode& node) {
   return error;
 }
 
-void LinearMethod::updateWeights(NeuralNode& node, double learn,
-                                 double momentum) {
-  std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
-  std::vector<double>& cWeights = node.getChangeInWeights();
-  std::vector<double>& weights = node.getWeights();
-
-  double learnTimesError = learn * node.errorValue(false);
-
-  double c = learnTimesError + momentum * cWeights[0];
-  weights[0] += c;
-  cWeights[0] = c;
-
-  for (unsigned int i = 1; i < inputs.size() + 1; i++) {
-    c = learnTimesError * inputs[i - 1]->outputValue(false);
-    c += momentum * cWeights[i];
-
-    weights[i] += c;
-    cWeights[i] = c;
-  }
-}
-
 double SigmoidMethod::outputValue(NeuralNode& node) {
   std::vector<double>& weights = node.getWeights();
   std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
@@ -88,27 +88,6 @@ double SigmoidMethod::errorValue(NeuralNode& node) {
   return error;
 }
 
-void SigmoidMethod::updateWeights(NeuralNode& node, double learn,
-                                  double momentum) {
-  std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
-  std::vector<double>& cWeights = node.getChangeInWeights();
-  std::vector<double>& weights = node.getWeights();
-
-  double learnTimesError = learn * node.errorValue(false);
-
-  double c = learnTimesError + momentum * cWeights[0];
-  weights[0] += c;
-  cWeights[0] = c;
-
-  for (unsigned int i = 1; i < inputs.size() + 1; i++) {
-    c = learnTimesError * inputs[i - 1]->outputValue(false);
-    c += momentum * cWeights[i];
-
-    weights[i] += c;
-    cWeights[i] = c;
-  }
-}
-
 double StepMethod::outputValue(NeuralNode& node) {
   std::vector<double>& weights = node.getWeights();
   std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
@@ -122,27 +101,6 @@ double StepMethod::outputValue(NeuralNode& node) {
   return value >= weights[0] ? 1.0 : 0.0;
 }
 
-void StepMethod::updateWeights(NeuralNode& node, double learn,
-                               double momentum) {
-  std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
-  std::vector<double>& cWeights = node.getChangeInWeights();
-  std::vector<double>& weights = node.getWeights();
-
-  double learnTimesError = learn * node.errorValue(false);
-
-  double c = learnTimesError + momentum * cWeights[0];
-  weights[0] += c;
-  cWeights[0] = c;
-
-  for (unsigned int i = 1; i < inputs.size() + 1; i++) {
-    c = learnTimesError * inputs[i - 1]->outputValue(false);
-    c += momentum * cWeights[i];
-
-    weights[i] += c;
-    cWeights[i] = c;
-  }
-}
-
 double BipolarSemilinearMethod::outputValue(NeuralNode& node) {
   std::vector<double>& weights = node.getWeights();
   std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
@@ -152,7 +110,7 @@ double BipolarSemilinearMethod::outputValue(NeuralNode& node) {
   }
 
   if (value < -45) {
-    value = 0;
+    value = -1;
   } else if (value > 45) {
     value = 1;
   } else {
@@ -170,30 +128,9 @@ double BipolarSemilinearMethod::errorValue(NeuralNode& node) {
     error += outputs[i]->errorValue(true) * outputs[i]->weightValue(oNums[i]);
 
   double value = node.outputValue(false);
-  error *= 2 * beta * value * (1 - value);
+  error *= beta * (1 + value) * (1 - value) / 2;
   return error;
 }
 
-void BipolarSemilinearMethod::updateWeights(NeuralNode& node, double learn,
-                                            double momentum) {
-  std::vector<NeuralConnectionPtr>& inputs = node.getInputs();
-  std::vector<double>& cWeights = node.getChangeInWeights();
-  std::vector<double>& weights = node.getWeights();
-
-  double learnTimesError = learn * node.errorValue(false);
-
-  double c = learnTimesError + momentum * cWeights[0];
-  weights[0] += c;
-  cWeights[0] = c;
-
-  for (unsigned int i = 1; i < inputs.size() + 1; i++) {
-    c = learnTimesError * inputs[i - 1]->outputValue(false);
-    c += momentum * cWeights[i];
-
-    weights[i] += c;
-    cWeights[i] = c;
-  }
-}
-
 }  // namespace neural
 }  // namespace nalso
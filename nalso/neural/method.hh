@@ -46,7 +46,9 @@ class NeuralMethod {
   virtual double errorValue(NeuralNode& node) = 0;
   /**
    * This function will calculate what the change in weights should be and
-   * also update them.
+   * also update them. The default implementation is gradient descent with
+   * momentum, which only depends on the error value of the node, so
+   * activation functions seldom need to override it.
    *
    * @param node The node to update the weights for.
    *
@@ -54,8 +56,9 @@ class NeuralMethod {
    *
    * @param momentum The momentum to use.
    */
-  virtual void updateWeights(NeuralNode& node, double learn,
-                             double momentum) = 0;
+  virtual void updateWeights(NeuralNode& node, double learn, double momentum);
+
+  virtual ~NeuralMethod() {}
 };
 
 /**
@@ -70,7 +73,6 @@ class LinearMethod : public NeuralMethod {
 
   double outputValue(NeuralNode& node);
   double errorValue(NeuralNode& node);
-  void updateWeights(NeuralNode& node, double learn, double momentum);
 };
 
 /**
@@ -86,7 +88,6 @@ class SigmoidMethod : public NeuralMethod {
 
   double outputValue(NeuralNode& node);
   double errorValue(NeuralNode& node);
-  void updateWeights(NeuralNode& node, double learn, double momentum);
 };
 
 /**
@@ -108,7 +109,6 @@ class StepMethod : public NeuralMethod {
    * @return NaN
    */
   double errorValue(NeuralNode& node) { return NAN; };
-  void updateWeights(NeuralNode& node, double learn, double momentum);
 };
 
 /**
@@ -131,9 +131,15 @@ class BipolarSemilinearMethod : public NeuralMethod {
   BipolarSemilinearMethod(double beta_ = 1.0) : beta(beta_) {}
   virtual ~BipolarSemilinearMethod() {};
 
+  /**
+   * Getter of the beta attribute.
+   *
+   * @return the sharpness of the function.
+   */
+  double getBeta() { return beta; }
+
   double outputValue(NeuralNode& node);
   double errorValue(NeuralNode& node);
-  void updateWeights(NeuralNode& node, double learn, double momentum);
 };
 
 }  // namespace neural
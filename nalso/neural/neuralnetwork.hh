@@ -15,6 +15,9 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
+
+#include "nalso/neural/fixpoint.hh"
 
 namespace nalso {
 /**
@@ -70,6 +73,10 @@ class NeuralNetwork {
    * tolerance parameter) to its equivalent element in the input (i.e. a
    * fixpoint is reached).
    *
+   * Since some networks never settle, e.g. those of programs without a stable
+   * model, the iteration also stops when a state of the last iterations comes
+   * back or when the budget runs out, see FixPointMonitor.
+   *
    * @remarks Only works when the input layer and the output one have nodes with
    * the same labels.
    *
@@ -79,16 +86,35 @@ class NeuralNetwork {
    * @param tolerance The minimum acceptable difference to consider two elements
    * equal.
    *
-   * @return The ParamsMap containing the fixpoint of the network.
+   * @param budget The limits of the iteration.
+   *
+   * @param result If not NULL, receives how the iteration ended.
+   *
+   * @return The ParamsMap containing the fixpoint of the network, or the last
+   * state reached if the iteration did not converge.
    */
-  virtual ParamsMap findFixPoint(ParamsMap input, double tolerance = 0) {
+  virtual ParamsMap findFixPoint(ParamsMap input, double tolerance = 0,
+                                 const FixPointBudget& budget = FixPointBudget(),
+                                 FixPointResult* result = NULL) {
+    FixPointMonitor monitor(budget, tolerance);
+    std::vector<double> state;
     ParamsMap newSet = input;
     ParamsMap oldSet;
-    do {
-      oldSet = newSet;
+    while (true) {
+      oldSet.swap(newSet);
       newSet = evaluate(oldSet);
-    } while (!NeuralNetwork::areEqualParameters(newSet, oldSet, tolerance));
+      if (NeuralNetwork::areEqualParameters(newSet, oldSet, tolerance)) {
+        monitor.converged();
+        break;
+      }
+      state.clear();
+      for (ParamsMap::iterator it = newSet.begin(); it != newSet.end(); it++) {
+        state.push_back((*it).second);
+      }
+      if (!monitor.proceed(state)) break;
+    }
 
+    if (result) *result = monitor.getResult();
     return newSet;
   }
 
@@ -110,11 +136,13 @@ class NeuralNetwork {
    * @return true if the absolute value of the difference of each to elements
    * with the same key is less than the tolerance value, false otherwise.
    */
-  static bool areEqualParameters(ParamsMap first, ParamsMap second,
+  static bool areEqualParameters(const ParamsMap& first, const ParamsMap& second,
                                  double tolerance = 0) {
-    for (ParamsMap::iterator it = first.begin(); it != first.end(); it++)
-      if (std::abs((*it).second - second[(*it).first]) > tolerance)
-        return false;
+    for (ParamsMap::const_iterator it = first.begin(); it != first.end(); it++) {
+      ParamsMap::const_iterator other = second.find((*it).first);
+      double value = other == second.end() ? 0 : (*other).second;
+      if (std::abs((*it).second - value) > tolerance) return false;
+    }
     return true;
   }
 
@@ -7,6 +7,8 @@
 
 #include "node.hh"
 
+#include <cmath>
+
 namespace nalso {
 
 namespace neural {
@@ -33,16 +35,21 @@ NeuralNode::NeuralNode(std::string _id, NeuralMethodPtr _method, RandomPtr _rand
 }
 
 double NeuralNode::outputValue(bool calculate) {
-  if (isnan(unitValue) && calculate) unitValue = (*method).outputValue(*this);
+  if (!valueComputed() && calculate) {
+    unitValue = (*method).outputValue(*this);
+    valueStamp = *epoch;
+  }
 
-  return unitValue;
+  return valueComputed() ? unitValue : NAN;
 }
 
 double NeuralNode::errorValue(bool calculate) {
-  if (!isnan(unitValue) && isnan(unitError) && calculate)
+  if (valueComputed() && !errorComputed() && calculate) {
     unitError = method->errorValue(*this);
+    errorStamp = *epoch;
+  }
 
-  return unitError;
+  return errorComputed() ? unitError : NAN;
 }
 
 void NeuralNode::saveWeights() {
@@ -59,10 +66,8 @@ void NeuralNode::restoreWeights() {
 }
 
 void NeuralNode::reset() {
-  if (!isnan(unitValue) || !isnan(unitError)) {
-    unitValue = NAN;
-    unitError = NAN;
-    weightsUpdated = false;
+  if (valueComputed() || errorComputed()) {
+    invalidate();
     for (unsigned int i = 0; i < inputList.size(); i++) inputList[i]->reset();
   }
 }
@@ -74,7 +79,7 @@ double NeuralNode::weightValue(int index) {
 }
 
 void NeuralNode::updateWeights(double learning, double momentum) {
-  if (!weightsUpdated && !isnan(unitError))
+  if (weightsStamp != *epoch && errorComputed())
     method->updateWeights(*this, learning, momentum);
 
   NeuralConnection::updateWeights(learning, momentum);
@@ -84,7 +89,7 @@ bool NeuralNode::connectInput(NeuralConnectionPtr i, int n,
                               double weight /*= NAN*/) {
   if (!NeuralConnection::connectInput(i, n)) return false;
 
-  if (isnan(weight))
+  if (std::isnan(weight))
     weights.push_back(((*random)()) * 0.1 - .05);
   else
     weights.push_back(weight);
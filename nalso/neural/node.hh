@@ -62,8 +62,16 @@ class NeuralConnection {
 
   double unitValue, unitError;
 
-  bool weightsUpdated; /** keeps track of which units have updated its weights
-                          already after each iteration */
+  /**
+   * Evaluation epoch, shared by all the nodes of a network. The value, the
+   * error and the weight update of the unit are only valid while their stamp
+   * is equal to the current epoch, so a whole network is reset by increasing
+   * the shared counter instead of visiting every node.
+   */
+  std::shared_ptr<unsigned long> epoch;
+  unsigned long valueStamp, errorStamp;
+  unsigned long weightsStamp; /** keeps track of which units have updated its
+                                 weights already after each iteration */
 
   std::string id; /** Unique identifier of the node inside a network */
 
@@ -147,6 +155,20 @@ class NeuralConnection {
    */
   bool operator!=(NeuralConnection& other) const { return !(*this == other); };
 
+  /**
+   * Makes this unit use the given evaluation epoch counter. Networks share one
+   * counter among all their nodes.
+   *
+   * @param _epoch A pointer to the epoch counter.
+   */
+  void setEpoch(std::shared_ptr<unsigned long> _epoch) { epoch = _epoch; }
+  /**
+   * Getter of the epoch attribute.
+   *
+   * @return a pointer to the epoch counter used by this unit.
+   */
+  std::shared_ptr<unsigned long> getEpoch() { return epoch; }
+
   /**
    * Call this to reset the unit for another run. It is expected by that this
    * unit will call the reset functions of all input units to it. It is also
@@ -324,6 +346,24 @@ class NeuralConnection {
   virtual int getSubnetwork() { return 0; }
 
  protected:
+  /**
+   * Tells whether the output value was computed in the current epoch.
+   *
+   * @return true if unitValue holds the value of the current run.
+   */
+  bool valueComputed() { return valueStamp == *epoch; }
+  /**
+   * Tells whether the error value was computed in the current epoch.
+   *
+   * @return true if unitError holds the error of the current run.
+   */
+  bool errorComputed() { return errorStamp == *epoch; }
+  /**
+   * Invalidates the value, the error and the weight update of this unit
+   * without changing the epoch of the network.
+   */
+  void invalidate() { valueStamp = errorStamp = weightsStamp = 0; }
+
   /**
    * This will connect the specified unit to be an input to this unit.
    *
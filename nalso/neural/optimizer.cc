@@ -0,0 +1,109 @@
+/**
+ * @file optimizer.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "optimizer.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace nalso {
+namespace neural {
+
+void MomentumSgd::update(const double* gradient, unsigned int first,
+                         unsigned int last) {
+  double* weights = network->section(CompiledNetwork::WEIGHTS);
+  double* change = network->section(CompiledNetwork::CHANGE_IN_WEIGHTS);
+  for (unsigned int i = first; i < last; i++) {
+    double c = learning * gradient[i] + momentum * change[i];
+    weights[i] += c;
+    change[i] = c;
+  }
+}
+
+void MomentumSgd::updateShared(const double* gradient, unsigned int first,
+                               unsigned int last) {
+  double* weights = network->section(CompiledNetwork::WEIGHTS);
+  double* change = network->section(CompiledNetwork::CHANGE_IN_WEIGHTS);
+  // relaxed atomics keep concurrent updates lock free and race free, since
+  // the workers read the weights through atomics as well, but an update which
+  // collides with another one may simply be lost
+  for (unsigned int i = first; i < last; i++) {
+    std::atomic_ref<double> weight(weights[i]), lastChange(change[i]);
+    double c = learning * gradient[i] +
+               momentum * lastChange.load(std::memory_order_relaxed);
+    weight.store(weight.load(std::memory_order_relaxed) + c,
+                 std::memory_order_relaxed);
+    lastChange.store(c, std::memory_order_relaxed);
+  }
+}
+
+void RProp::allocate(CompiledNetwork& _network) {
+  steps = _network.addSections(2);
+  previous = steps + 1;
+  std::fill_n(_network.section(steps), _network.getSectionSize(), initialStep);
+}
+
+void RProp::release(CompiledNetwork& _network) {
+  _network.releaseSections(steps, 2);
+}
+
+void RProp::update(const double* gradient, unsigned int first,
+                   unsigned int last) {
+  double* weights = network->section(CompiledNetwork::WEIGHTS);
+  double* step = network->section(steps);
+  double* before = network->section(previous);
+  for (unsigned int i = first; i < last; i++) {
+    double g = gradient[i];
+    double sign = g * before[i];
+    if (sign > 0) {
+      step[i] = std::min(step[i] * increase, maxStep);
+    } else if (sign < 0) {
+      // the last change jumped over a minimum, wait for the next batch
+      step[i] = std::max(step[i] * decrease, minStep);
+      g = 0;
+    }
+    if (g > 0) {
+      weights[i] += step[i];
+    } else if (g < 0) {
+      weights[i] -= step[i];
+    }
+    before[i] = g;
+  }
+}
+
+void Adam::allocate(CompiledNetwork& _network) {
+  moments = _network.addSections(2);
+  squares = moments + 1;
+  t = 0;
+}
+
+void Adam::release(CompiledNetwork& _network) {
+  _network.releaseSections(moments, 2);
+}
+
+void Adam::beginBatch() {
+  t++;
+  correction1 = 1 - std::pow(beta1, (double)t);
+  correction2 = 1 - std::pow(beta2, (double)t);
+}
+
+void Adam::update(const double* gradient, unsigned int first,
+                  unsigned int last) {
+  double* weights = network->section(CompiledNetwork::WEIGHTS);
+  double* m = network->section(moments);
+  double* v = network->section(squares);
+  for (unsigned int i = first; i < last; i++) {
+    double g = gradient[i];
+    m[i] = beta1 * m[i] + (1 - beta1) * g;
+    v[i] = beta2 * v[i] + (1 - beta2) * g * g;
+    weights[i] += learning * (m[i] / correction1) /
+                  (std::sqrt(v[i] / correction2) + epsilon);
+  }
+}
+
+}  // namespace neural
+}  // namespace nalso
@@ -0,0 +1,239 @@
+#pragma once
+/**
+ * @file optimizer.hh
+ *
+ * @brief Update rules applied to the weights of a compiled network.
+ *
+ * Contains the interface used by the Trainer to turn the gradient of a batch
+ * into a change of the weights, together with momentum gradient descent,
+ * RProp and Adam.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <memory>
+
+#include "nalso/neural/compiled.hh"
+
+namespace nalso {
+namespace neural {
+
+/**
+ * @brief Interface for the rules which update the weights of a network.
+ *
+ * An optimiser keeps whatever state it needs per weight in sections of the
+ * weight arena of the network, so the state shares the layout of the weights
+ * and is updated by the same linear loop. The gradient it receives is the
+ * direction in which the squared error decreases, averaged over a batch, in
+ * the layout of a section of the arena.
+ */
+class Optimizer {
+ protected:
+  /** Network the state was allocated in */
+  CompiledNetwork* network;
+
+  /**
+   * Allocates the state of the optimiser in the arena of the network.
+   */
+  virtual void allocate(CompiledNetwork&) {}
+  /**
+   * Releases the sections allocated by allocate.
+   */
+  virtual void release(CompiledNetwork&) {}
+
+ public:
+  Optimizer() : network(0) {}
+  virtual ~Optimizer() {}
+
+  /**
+   * Prepares the optimiser to update the weights of a network. The state is
+   * allocated the first time a network is attached, attaching another network
+   * releases the state from the previous one, which must still exist, and
+   * allocates a new state in the new one.
+   *
+   * @param _network The network whose weights will be updated.
+   */
+  void attach(CompiledNetwork& _network) {
+    if (network == &_network) return;
+    detach();
+    allocate(_network);
+    network = &_network;
+  }
+  /**
+   * Releases the state of the optimiser from the attached network, if any,
+   * so its sections can be reused.
+   */
+  void detach() {
+    if (network) release(*network);
+    network = 0;
+  }
+
+  /**
+   * Called once before the updates of each batch.
+   */
+  virtual void beginBatch() {}
+
+  /**
+   * Updates the weights in [first, last) of the attached network. The ranges
+   * of a batch are disjoint and may be updated by different threads.
+   *
+   * @param gradient The averaged gradient of the batch, indexed like a section
+   * of the arena.
+   *
+   * @param first The first weight to update.
+   *
+   * @param last One past the last weight to update.
+   */
+  virtual void update(const double* gradient, unsigned int first,
+                      unsigned int last) = 0;
+
+  /**
+   * Tells whether updateShared can be called by several threads at once over
+   * the same weights.
+   *
+   * @return true if the optimiser supports Hogwild training.
+   */
+  virtual bool lockFree() { return false; }
+  /**
+   * Same as update but safe to call while other threads read and update the
+   * same weights, when lockFree returns true. The weights have to be read and
+   * written through relaxed atomics, as the readers do.
+   */
+  virtual void updateShared(const double* gradient, unsigned int first,
+                            unsigned int last) {
+    update(gradient, first, last);
+  }
+};
+
+typedef std::shared_ptr<Optimizer> OptimizerPtr;
+
+/**
+ * @brief Gradient descent with momentum.
+ *
+ * The rule of NeuralMethod::updateWeights: each change is the gradient times
+ * the learning rate plus the last change times the momentum. The last changes
+ * are kept in the CHANGE_IN_WEIGHTS section, so they are copied back into the
+ * nodes along with the weights.
+ */
+class MomentumSgd : public Optimizer {
+ private:
+  double learning;
+  double momentum;
+
+ public:
+  /**
+   * @param _learning The learning rate.
+   *
+   * @param _momentum The fraction of the last change added to each change.
+   */
+  MomentumSgd(double _learning = 0.3, double _momentum = 0.2)
+      : learning(_learning), momentum(_momentum) {}
+
+  void update(const double* gradient, unsigned int first, unsigned int last);
+  bool lockFree() { return true; }
+  void updateShared(const double* gradient, unsigned int first, unsigned int last);
+
+  void setLearning(double _learning) { learning = _learning; }
+  void setMomentum(double _momentum) { momentum = _momentum; }
+  double getLearning() { return learning; }
+  double getMomentum() { return momentum; }
+};
+
+/**
+ * @brief Resilient backpropagation (iRprop-).
+ *
+ * Only the sign of the gradient is used: every weight has its own step which
+ * grows while the sign of its gradient holds and shrinks when it flips, in
+ * which case the weight is left alone for that batch. It is meant to be used
+ * with batches covering the whole dataset.
+ */
+class RProp : public Optimizer {
+ private:
+  double initialStep;
+  double increase;
+  double decrease;
+  double minStep;
+  double maxStep;
+  /** Sections holding the step and the last gradient of each weight */
+  unsigned int steps, previous;
+
+ protected:
+  void allocate(CompiledNetwork& _network);
+  void release(CompiledNetwork& _network);
+
+ public:
+  /**
+   * @param _initialStep The step of every weight before the first batch.
+   *
+   * @param _increase Factor applied to the step while the sign holds.
+   *
+   * @param _decrease Factor applied to the step when the sign flips.
+   *
+   * @param _minStep Lower bound of the steps.
+   *
+   * @param _maxStep Upper bound of the steps.
+   */
+  RProp(double _initialStep = 0.1, double _increase = 1.2, double _decrease = 0.5,
+        double _minStep = 1e-6, double _maxStep = 50)
+      : initialStep(_initialStep),
+        increase(_increase),
+        decrease(_decrease),
+        minStep(_minStep),
+        maxStep(_maxStep),
+        steps(0),
+        previous(0) {}
+
+  void update(const double* gradient, unsigned int first, unsigned int last);
+};
+
+/**
+ * @brief Adaptive moment estimation.
+ *
+ * Keeps running averages of the gradient and of its square for every weight
+ * and scales each change by their ratio, with the usual bias correction of
+ * the first batches.
+ */
+class Adam : public Optimizer {
+ private:
+  double learning;
+  double beta1;
+  double beta2;
+  double epsilon;
+  /** Number of batches seen and the bias corrections derived from it */
+  unsigned long t;
+  double correction1, correction2;
+  /** Sections holding the first and second moments of each weight */
+  unsigned int moments, squares;
+
+ protected:
+  void allocate(CompiledNetwork& _network);
+  void release(CompiledNetwork& _network);
+
+ public:
+  /**
+   * @param _learning The learning rate.
+   *
+   * @param _beta1 Decay of the average of the gradient.
+   *
+   * @param _beta2 Decay of the average of the squared gradient.
+   *
+   * @param _epsilon Added to the denominator to avoid dividing by zero.
+   */
+  Adam(double _learning = 0.001, double _beta1 = 0.9, double _beta2 = 0.999,
+       double _epsilon = 1e-8)
+      : learning(_learning),
+        beta1(_beta1),
+        beta2(_beta2),
+        epsilon(_epsilon),
+        t(0),
+        correction1(1),
+        correction2(1),
+        moments(0),
+        squares(0) {}
+
+  void beginBatch();
+  void update(const double* gradient, unsigned int first, unsigned int last);
+};
+
+}  // namespace neural
+}  // namespace nalso
@@ -0,0 +1,167 @@
+/**
+ * @file recurrent.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "recurrent.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace nalso {
+namespace neural {
+
+RecurrentNetworkPtr RecurrentNetwork::compile(CompiledNetworkPtr _network,
+                                              const std::vector<int>& _feedback) {
+  RecurrentNetworkPtr res(new RecurrentNetwork);
+  if (_feedback.size() != _network->noInputs()) return RecurrentNetworkPtr();
+  for (unsigned int i = 0; i < _feedback.size(); i++) {
+    if (_feedback[i] >= (int)_network->noOutputs()) return RecurrentNetworkPtr();
+  }
+
+  res->network = IncrementalNetwork::compile(_network);
+  res->feedback = _feedback;
+  res->current.resize(_feedback.size());
+  res->next.resize(_feedback.size());
+  res->sortDependencies();
+  return res;
+}
+
+void RecurrentNetwork::sortDependencies() {
+  CompiledNetwork& net = *network->getNetwork();
+  unsigned int base = net.leaves.size();
+  unsigned int ports = feedback.size();
+
+  // the fed inputs each output reads, found walking the plan backwards from
+  // the slot of the output
+  std::vector<std::vector<unsigned int> > readers(ports);
+  std::vector<unsigned int> waiting(ports, 0);
+  std::vector<unsigned int> seen(base + net.noNodes(), 0), stack;
+  for (unsigned int i = 0; i < ports; i++) {
+    if (feedback[i] < 0 || net.outputSource[feedback[i]] < 0) continue;
+    stack.push_back(net.outputSource[feedback[i]]);
+    seen[stack.back()] = i + 1;
+    while (!stack.empty()) {
+      unsigned int slot = stack.back();
+      stack.pop_back();
+      if (slot < base) {
+        // an atom does not wait for itself
+        if (slot < ports && slot != i && feedback[slot] >= 0) {
+          readers[slot].push_back(i);
+          waiting[i]++;
+        }
+        continue;
+      }
+      unsigned int node = slot - base;
+      for (unsigned int e = net.rowStart[node]; e < net.rowStart[node + 1]; e++) {
+        if (seen[net.column[e]] == i + 1) continue;
+        seen[net.column[e]] = i + 1;
+        stack.push_back(net.column[e]);
+      }
+    }
+  }
+
+  // Kahn's algorithm taking the lowest ready port first, when every port left
+  // waits for another one they form a cycle, which is broken at its lowest port
+  std::vector<unsigned char> placed(ports, 0);
+  std::vector<unsigned int> ready;
+  unsigned int fed = 0, next = 0;
+  for (unsigned int i = 0; i < ports; i++) {
+    if (feedback[i] < 0) continue;
+    fed++;
+    if (!waiting[i]) ready.push_back(i);
+  }
+  std::make_heap(ready.begin(), ready.end(), std::greater<unsigned int>());
+
+  order.clear();
+  while (order.size() < fed) {
+    if (ready.empty()) {
+      while (placed[next] || feedback[next] < 0) next++;
+      ready.push_back(next);
+    }
+    std::pop_heap(ready.begin(), ready.end(), std::greater<unsigned int>());
+    unsigned int port = ready.back();
+    ready.pop_back();
+    if (placed[port]) continue;
+    placed[port] = 1;
+    order.push_back(port);
+    for (unsigned int k = 0; k < readers[port].size(); k++) {
+      unsigned int reader = readers[port][k];
+      if (--waiting[reader] == 0 && !placed[reader]) {
+        ready.push_back(reader);
+        std::push_heap(ready.begin(), ready.end(), std::greater<unsigned int>());
+      }
+    }
+  }
+}
+
+bool RecurrentNetwork::setOrder(const std::vector<unsigned int>& _order) {
+  std::vector<unsigned char> listed(feedback.size(), 0);
+  unsigned int fed = 0;
+  for (unsigned int i = 0; i < feedback.size(); i++) fed += feedback[i] >= 0;
+  if (_order.size() != fed) return false;
+  for (unsigned int k = 0; k < _order.size(); k++) {
+    unsigned int port = _order[k];
+    if (port >= feedback.size() || feedback[port] < 0 || listed[port]) return false;
+    listed[port] = 1;
+  }
+  order = _order;
+  return true;
+}
+
+bool RecurrentNetwork::iterateSynchronous(std::span<double> output, double tolerance) {
+  network->evaluate(current, output);
+
+  bool equal = true;
+  for (unsigned int i = 0; i < current.size(); i++) {
+    next[i] = feedback[i] < 0 ? current[i] : output[feedback[i]];
+    equal = equal && std::fabs(next[i] - current[i]) <= tolerance;
+  }
+  current.swap(next);
+  return equal;
+}
+
+bool RecurrentNetwork::iterateAsynchronous(double tolerance) {
+  bool equal = true;
+  for (unsigned int k = 0; k < order.size(); k++) {
+    unsigned int port = order[k];
+    double value = network->outputValue(feedback[port]);
+    equal = equal && std::fabs(value - current[port]) <= tolerance;
+    current[port] = value;
+    network->setInput(port, value);
+  }
+  return equal;
+}
+
+FixPointResult RecurrentNetwork::findFixPoint(std::span<const double> input,
+                                              std::span<double> output,
+                                              double tolerance,
+                                              const FixPointBudget& budget) {
+  std::copy_n(input.begin(), current.size(), current.begin());
+  // the ends which are not inputs may have changed since the last call
+  network->reset();
+  // the sweeps start from the outputs of the initial inputs
+  if (mode == ASYNCHRONOUS_UPDATE) network->evaluate(current, output);
+
+  FixPointMonitor monitor(budget, tolerance);
+  while (true) {
+    bool equal = mode == ASYNCHRONOUS_UPDATE ? iterateAsynchronous(tolerance)
+                                             : iterateSynchronous(output, tolerance);
+    if (equal) {
+      monitor.converged();
+      break;
+    }
+    if (!monitor.proceed(current)) break;
+  }
+
+  if (mode == ASYNCHRONOUS_UPDATE) {
+    unsigned int outputs = network->getNetwork()->noOutputs();
+    for (unsigned int o = 0; o < outputs; o++) output[o] = network->outputValue(o);
+  }
+  return monitor.getResult();
+}
+
+}  // namespace neural
+}  // namespace nalso
@@ -0,0 +1,148 @@
+#pragma once
+/**
+ * @file recurrent.hh
+ *
+ * @brief Fixpoints of networks whose outputs are fed back to their inputs.
+ *
+ * Contains the declaration of an engine which iterates a compiled network
+ * feeding each output back to the input of the same atom, as done to compute
+ * the stable models of a program through the network built by Cilp.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "nalso/neural/compiled.hh"
+#include "nalso/neural/fixpoint.hh"
+#include "nalso/neural/incremental.hh"
+
+namespace nalso {
+namespace neural {
+
+/**
+ * @brief A compiled network whose outputs are wired back to its inputs.
+ *
+ * Every input port is fed either by an output port, fixed when the engine is
+ * built, or keeps the value it was given. Finding the fixpoint then alternates
+ * two buffers of input values, the outputs of the network for one being
+ * copied into the other, until no input moves by more than the tolerance, see
+ * FixPointMonitor for the other ways the iteration may end. No label is looked
+ * up while iterating, and since after the first iterations only a few atoms
+ * change, the network is evaluated by an IncrementalNetwork which only
+ * recomputes the nodes they reach.
+ *
+ * In the asynchronous mode each iteration is a Gauss-Seidel sweep instead: the
+ * inputs are visited in dependency order, an atom coming after the atoms its
+ * clauses read, and each one takes the value of its output at once, so the
+ * atoms after it already see it in the same sweep. The order is found from the
+ * wiring of the network when the engine is built, breaking cycles by port,
+ * and a program without cycles settles in one or two sweeps instead of as
+ * many iterations as the length of its longest chain of dependencies.
+ *
+ * The weights are read when the engine is built, so it has to be built again
+ * after training.
+ */
+class RecurrentNetwork {
+ private:
+  IncrementalNetworkPtr network;
+  /** Output port feeding each input port, -1 for the inputs kept fixed */
+  std::vector<int> feedback;
+  UpdateMode mode;
+  /** The input ports fed by an output, in dependency order */
+  std::vector<unsigned int> order;
+
+  /** The inputs of the current and of the next iteration */
+  std::vector<double> current, next;
+
+  RecurrentNetwork() : mode(SYNCHRONOUS_UPDATE) {}
+
+  /**
+   * Sorts the input ports fed by an output so that each one comes after the
+   * inputs its output depends on.
+   */
+  void sortDependencies();
+  /**
+   * Runs one synchronous iteration and tells whether the inputs kept their
+   * values.
+   */
+  bool iterateSynchronous(std::span<double> output, double tolerance);
+  /**
+   * Runs one asynchronous sweep and tells whether the inputs kept their
+   * values.
+   */
+  bool iterateAsynchronous(double tolerance);
+
+ public:
+  /**
+   * Builds the engine of a compiled network.
+   *
+   * @param _network The compiled network.
+   *
+   * @param _feedback The output port feeding each input port, -1 for inputs
+   * which keep their value.
+   *
+   * @return A pointer to the engine or an empty pointer if the sizes of the
+   * network and of the wiring do not match.
+   */
+  static std::shared_ptr<RecurrentNetwork> compile(CompiledNetworkPtr _network,
+                                                   const std::vector<int>& _feedback);
+
+  /**
+   * Iterates the network from the given inputs until its outputs are equal to
+   * the inputs they feed, a cycle of inputs is found or the budget runs out.
+   *
+   * @param input The initial value of each input, indexed by input port.
+   *
+   * @param output Buffer where the value of each output, indexed by output
+   * port, after the last iteration is written.
+   *
+   * @param tolerance The largest difference between an output and the input
+   * it feeds for both to be considered equal.
+   *
+   * @param budget The limits of the iteration.
+   *
+   * @return How the iteration ended and the number of times the network was
+   * evaluated.
+   */
+  FixPointResult findFixPoint(std::span<const double> input, std::span<double> output,
+                              double tolerance = 0,
+                              const FixPointBudget& budget = FixPointBudget());
+
+  /**
+   * Selects how the outputs are fed back to the inputs.
+   *
+   * @param _mode The update mode.
+   */
+  void setUpdateMode(UpdateMode _mode) { mode = _mode; }
+  UpdateMode getUpdateMode() { return mode; }
+
+  /**
+   * Replaces the order in which the asynchronous sweeps visit the inputs,
+   * e.g. with the dependency order of the program the network was built from.
+   *
+   * @param _order Input ports fed by an output, each of them once.
+   *
+   * @return false if the order is not a permutation of those ports, in which
+   * case it does not change.
+   */
+  bool setOrder(const std::vector<unsigned int>& _order);
+  const std::vector<unsigned int>& getOrder() { return order; }
+
+  /**
+   * Returns the output port feeding an input port.
+   *
+   * @param port The input port.
+   *
+   * @return The output port or -1 if the input keeps its value.
+   */
+  int feedbackPort(unsigned int port) { return feedback[port]; }
+  CompiledNetworkPtr getNetwork() { return network->getNetwork(); }
+};
+
+typedef std::shared_ptr<RecurrentNetwork> RecurrentNetworkPtr;
+
+}  // namespace neural
+}  // namespace nalso
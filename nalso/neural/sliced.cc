@@ -0,0 +1,247 @@
+/**
+ * @file sliced.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "sliced.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "nalso/neural/kernels.hh"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NALSO_X86_SLICED 1
+#endif
+
+namespace nalso {
+namespace neural {
+
+namespace {
+
+const unsigned int B = SlicedNetwork::BLOCK_WORDS;
+/** Planes needed by a counter holding MAX_WEIGHT_SUM */
+const unsigned int MAX_WIDTH = 21;
+
+/** The arrays of a SlicedNetwork read while evaluating a block */
+struct Circuit {
+  unsigned int base;
+  unsigned int nodes;
+  const unsigned int* termStart;
+  const unsigned int* termSlot;
+  const unsigned int* termWeight;
+  const unsigned char* termNegated;
+  const unsigned int* width;
+  const long* bound;
+};
+
+/**
+ * Evaluates the nodes over one block of planes, the body shared by the
+ * versions compiled for each instruction set. The loops over the words of a
+ * block have a fixed trip count so the compiler turns them into SIMD
+ * instructions.
+ */
+__attribute__((always_inline)) inline void run(const Circuit& circuit,
+                                               uint64_t* planes) {
+  uint64_t counter[MAX_WIDTH][B];
+  uint64_t carry[B], borrow[B];
+
+  for (unsigned int n = 0; n < circuit.nodes; n++) {
+    uint64_t* out = planes + (circuit.base + n) * B;
+    long bound = circuit.bound[n];
+    unsigned int width = circuit.width[n];
+    if (bound < 0 || bound >> width) {
+      std::fill_n(out, B, bound < 0 ? ~(uint64_t)0 : 0);
+      continue;
+    }
+
+    for (unsigned int j = 0; j < width; j++) std::fill_n(counter[j], B, 0);
+    for (unsigned int e = circuit.termStart[n]; e < circuit.termStart[n + 1]; e++) {
+      const uint64_t* x = planes + circuit.termSlot[e] * B;
+      uint64_t negated = circuit.termNegated[e] ? ~(uint64_t)0 : 0;
+      // the term is added once for every bit set in its weight
+      unsigned int b = 0;
+      for (unsigned int q = circuit.termWeight[e]; q; q >>= 1, b++) {
+        if (!(q & 1)) continue;
+        for (unsigned int k = 0; k < B; k++) carry[k] = x[k] ^ negated;
+        for (unsigned int j = b; j < width; j++) {
+          uint64_t any = 0;
+          for (unsigned int k = 0; k < B; k++) {
+            uint64_t next = counter[j][k] & carry[k];
+            counter[j][k] ^= carry[k];
+            carry[k] = next;
+            any |= next;
+          }
+          if (!any) break;
+        }
+      }
+    }
+
+    // the lanes where counter - bound does not borrow
+    std::fill_n(borrow, B, 0);
+    for (unsigned int j = 0; j < width; j++) {
+      if ((bound >> j) & 1) {
+        for (unsigned int k = 0; k < B; k++) borrow[k] = ~counter[j][k] | borrow[k];
+      } else {
+        for (unsigned int k = 0; k < B; k++) borrow[k] = ~counter[j][k] & borrow[k];
+      }
+    }
+    for (unsigned int k = 0; k < B; k++) out[k] = ~borrow[k];
+  }
+}
+
+void runScalar(const Circuit& circuit, uint64_t* planes) { run(circuit, planes); }
+
+#ifdef NALSO_X86_SLICED
+__attribute__((target("avx2"))) void runAvx2(const Circuit& circuit,
+                                             uint64_t* planes) {
+  run(circuit, planes);
+}
+
+__attribute__((target("avx512f"))) void runAvx512(const Circuit& circuit,
+                                                  uint64_t* planes) {
+  run(circuit, planes);
+}
+#endif
+
+}  // namespace
+
+SlicedNetworkPtr SlicedNetwork::compile(CompiledNetworkPtr _network) {
+  SlicedNetworkPtr res(new SlicedNetwork);
+  CompiledNetwork& net = *_network;
+  unsigned int nodes = net.noNodes();
+  unsigned int base = net.leaves.size();
+  const double* weights = net.section(CompiledNetwork::WEIGHTS);
+  // the values of the ends which are not ports are unknown
+  if (base != net.numInputs) return SlicedNetworkPtr();
+
+  res->network = _network;
+  res->termStart.push_back(0);
+  for (unsigned int n = 0; n < nodes; n++) {
+    const double* block = weights + net.weightOffset[n];
+    unsigned int first = net.rowStart[n], last = net.rowStart[n + 1];
+
+    if (net.kind[n] == LINEAR_ACTIVATION) {
+      if (block[0] != 0 || last - first != 1 || block[1] != 1) return SlicedNetworkPtr();
+      res->termSlot.push_back(net.column[first]);
+      res->termWeight.push_back(1);
+      res->termNegated.push_back(0);
+      res->termStart.push_back(res->termSlot.size());
+      res->width.push_back(1);
+      res->bound.push_back(1);
+      continue;
+    }
+    if (net.kind[n] != STEP_ACTIVATION) return SlicedNetworkPtr();
+
+    // the greatest common divisor of the weights, fmod is exact so it is
+    // found whenever the weights have one
+    double unit = 0;
+    for (unsigned int k = 1; k <= last - first; k++) {
+      double a = std::fabs(block[k]), b = unit;
+      while (b != 0) {
+        double r = std::fmod(a, b);
+        a = b;
+        b = r;
+      }
+      unit = a;
+    }
+    if (unit == 0) unit = 1;
+
+    // the node is 1 when sum(q * x) >= threshold, with q the weights divided
+    // by the unit, and the negative terms are added as q * (1 - x) - q so the
+    // counter never goes below zero
+    unsigned long total = 0, negative = 0;
+    for (unsigned int e = first, k = 1; e < last; e++, k++) {
+      if (block[k] == 0) continue;
+      double q = std::round(std::fabs(block[k]) / unit);
+      if (q * unit != std::fabs(block[k]) || total + q > MAX_WEIGHT_SUM) {
+        return SlicedNetworkPtr();
+      }
+      res->termSlot.push_back(net.column[e]);
+      res->termWeight.push_back((unsigned int)q);
+      res->termNegated.push_back(block[k] < 0);
+      total += q;
+      if (block[k] < 0) negative += q;
+    }
+    res->termStart.push_back(res->termSlot.size());
+
+    unsigned int width = 0;
+    while (total >> width) width++;
+    res->width.push_back(width);
+
+    // the smallest integer t with unit * t >= bias, kept within the range of
+    // the sum so it fits in a long
+    double limit = (double)total + 1;
+    double t = std::ceil(std::min(std::max(block[0] / unit, -limit), limit));
+    while (t > -limit && unit * (t - 1) >= block[0]) t--;
+    while (t < limit && unit * t < block[0]) t++;
+    long bound = (long)t + (long)negative;
+    res->bound.push_back(bound <= 0 ? -1 : bound);
+  }
+
+  res->planes.resize((base + nodes) * B);
+  return res;
+}
+
+void SlicedNetwork::evaluate(std::span<const uint64_t> input,
+                             std::span<uint64_t> output, unsigned int words) {
+  CompiledNetwork& net = *network;
+  Circuit circuit = {(unsigned int)net.leaves.size(), net.noNodes(), termStart.data(),
+                     termSlot.data(), termWeight.data(), termNegated.data(),
+                     width.data(), bound.data()};
+  unsigned int inputs = net.numInputs, outputs = net.outputSource.size();
+
+  for (unsigned int w = 0; w < words; w += B) {
+    unsigned int count = std::min(B, words - w);
+    for (unsigned int i = 0; i < inputs; i++) {
+      uint64_t* plane = planes.data() + i * B;
+      std::copy_n(input.data() + i * words + w, count, plane);
+      std::fill(plane + count, plane + B, 0);
+    }
+
+    switch (kernels::getIsa()) {
+#ifdef NALSO_X86_SLICED
+      case AVX512_ISA:
+        runAvx512(circuit, planes.data());
+        break;
+      case AVX2_ISA:
+        runAvx2(circuit, planes.data());
+        break;
+#endif
+      default:
+        runScalar(circuit, planes.data());
+    }
+
+    for (unsigned int o = 0; o < outputs; o++) {
+      uint64_t* plane = output.data() + o * words + w;
+      if (net.outputSource[o] < 0) {
+        std::fill_n(plane, count, 0);
+      } else {
+        std::copy_n(planes.data() + net.outputSource[o] * B, count, plane);
+      }
+    }
+  }
+}
+
+void SlicedNetwork::enumerate(std::span<uint64_t> input, uint64_t first,
+                              unsigned int words) {
+  // the digits below 6 follow the position of the lane inside its word
+  static const uint64_t patterns[6] = {
+      0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+      0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull};
+  for (unsigned int i = 0; i < network->numInputs; i++) {
+    uint64_t* plane = input.data() + i * words;
+    for (unsigned int w = 0; w < words; w++) {
+      if (i < 6) {
+        plane[w] = patterns[i];
+      } else {
+        uint64_t number = first / 64 + w;
+        plane[w] = i - 6 < 64 && ((number >> (i - 6)) & 1) ? ~(uint64_t)0 : 0;
+      }
+    }
+  }
+}
+
+}  // namespace neural
+}  // namespace nalso
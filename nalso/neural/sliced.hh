@@ -0,0 +1,122 @@
+#pragma once
+/**
+ * @file sliced.hh
+ *
+ * @brief Bit sliced evaluation of networks of step units.
+ *
+ * Contains the declaration of an evaluator which computes the outputs of a
+ * threshold circuit for hundreds of input vectors at once, one bit of a
+ * machine word per input vector.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "nalso/neural/compiled.hh"
+
+namespace nalso {
+namespace neural {
+
+/**
+ * @brief A network of step units evaluated over many input vectors at once.
+ *
+ * Since StepMethod only yields 0 or 1, a network made of step units is a
+ * threshold circuit. The evaluator keeps, for every slot of the compiled
+ * network, a plane of bits holding the value of the slot for each of the
+ * input vectors, which are called lanes. The weighted sum of a node is
+ * accumulated in a bit sliced counter, an array of planes where plane j holds
+ * bit j of the sum of every lane, by ripple carry adders working on whole
+ * planes, and then compared with the threshold of the node by a bit sliced
+ * subtraction. Every operation thus works on 64 lanes per machine word, and
+ * the planes of BLOCK_WORDS words are processed with the SIMD instructions
+ * selected by kernels::setIsa.
+ *
+ * The weights of each node must be integer multiples of a common unit, their
+ * greatest common divisor, which makes the sum an integer once divided by it. The nodes of the
+ * network have to be step nodes or linear nodes with bias 0 passing the value
+ * of a single slot through, like the input nodes of FeedForwardNeuralNetwork.
+ * The weights are read when the evaluator is built.
+ */
+class SlicedNetwork {
+ public:
+  /** Words of a plane processed together, 512 lanes */
+  static const unsigned int BLOCK_WORDS = 8;
+  /** Upper bound of the sum of the weights of a node, in units of their
+   * greatest common divisor */
+  static const unsigned int MAX_WEIGHT_SUM = 1 << 20;
+
+ private:
+  CompiledNetworkPtr network;
+
+  /**
+   * Node n adds the terms [termStart[n], termStart[n + 1]), each the value of
+   * the slot termSlot[e], negated if termNegated[e], times termWeight[e].
+   */
+  std::vector<unsigned int> termStart;
+  std::vector<unsigned int> termSlot;
+  std::vector<unsigned int> termWeight;
+  std::vector<unsigned char> termNegated;
+  /** Number of planes of the counter of each node */
+  std::vector<unsigned int> width;
+  /**
+   * A node is 1 in the lanes where its counter reaches the bound, -1 means
+   * always and a bound which does not fit in the counter never
+   */
+  std::vector<long> bound;
+
+  /** Planes of every slot for one block of lanes */
+  std::vector<uint64_t> planes;
+
+  SlicedNetwork() {}
+
+ public:
+  /**
+   * Builds the bit sliced evaluator of a compiled network.
+   *
+   * @param _network The compiled network.
+   *
+   * @return A pointer to the evaluator or an empty pointer if some node is not
+   * a step or pass through node, or if the weights of a step node add up to
+   * more than MAX_WEIGHT_SUM times their greatest common divisor.
+   */
+  static std::shared_ptr<SlicedNetwork> compile(CompiledNetworkPtr _network);
+
+  /**
+   * Evaluates the network for 64 * words input vectors.
+   *
+   * @param input The planes of the inputs, input i of lane l is bit l % 64 of
+   * word i * words + l / 64. Every value is 0 or 1.
+   *
+   * @param output Room for the planes of the outputs in the same layout.
+   *
+   * @param words The number of words of each plane.
+   */
+  void evaluate(std::span<const uint64_t> input, std::span<uint64_t> output,
+                unsigned int words);
+
+  /**
+   * Fills the planes of the inputs so that lane l holds the binary digits of
+   * the number first + l, input i being digit i, e.g. to enumerate every
+   * interpretation of the inputs in blocks.
+   *
+   * @param input Room for noInputs() planes of the given number of words.
+   *
+   * @param first The number held by the first lane, a multiple of 64.
+   *
+   * @param words The number of words of each plane.
+   */
+  void enumerate(std::span<uint64_t> input, uint64_t first, unsigned int words);
+
+  unsigned int noInputs() { return network->noInputs(); }
+  unsigned int noOutputs() { return network->noOutputs(); }
+  CompiledNetworkPtr getNetwork() { return network; }
+};
+
+typedef std::shared_ptr<SlicedNetwork> SlicedNetworkPtr;
+
+}  // namespace neural
+}  // namespace nalso
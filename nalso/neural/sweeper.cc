@@ -0,0 +1,194 @@
+/**
+ * @file sweeper.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "sweeper.hh"
+
+#include <algorithm>
+#include <bit>
+
+#include "nalso/neural/kernels.hh"
+
+namespace nalso {
+namespace neural {
+
+TruthTableSweeperPtr TruthTableSweeper::compile(CompiledNetworkPtr _network,
+                                                TruthEncoding _encoding) {
+  TruthTableSweeperPtr res(new TruthTableSweeper);
+  CompiledNetwork& net = *_network;
+  unsigned int nodes = net.noNodes();
+  const double* weights = net.section(CompiledNetwork::WEIGHTS);
+  if (net.numInputs > MAX_INPUTS) return TruthTableSweeperPtr();
+
+  res->network = _network;
+  res->encoding = _encoding;
+
+  // the connections leaving each input, counted first to lay them out by input
+  res->inputStart.assign(net.numInputs + 1, 0);
+  for (unsigned int e = 0; e < net.column.size(); e++) {
+    if (net.column[e] < net.numInputs) res->inputStart[net.column[e] + 1]++;
+  }
+  for (unsigned int i = 0; i < net.numInputs; i++) {
+    res->inputStart[i + 1] += res->inputStart[i];
+  }
+  res->inputNode.resize(res->inputStart.back());
+  res->inputWeight.resize(res->inputStart.back());
+  std::vector<unsigned int> fill(res->inputStart.begin(), res->inputStart.end() - 1);
+
+  res->termStart.push_back(0);
+  for (unsigned int n = 0; n < nodes; n++) {
+    const double* block = weights + net.weightOffset[n];
+    res->bias.push_back(block[0]);
+    for (unsigned int e = net.rowStart[n], k = 1; e < net.rowStart[n + 1]; e++, k++) {
+      unsigned int slot = net.column[e];
+      if (slot < net.numInputs) {
+        res->inputNode[fill[slot]] = n;
+        res->inputWeight[fill[slot]++] = block[k];
+      } else {
+        res->termSlot.push_back(slot);
+        res->termWeight.push_back(block[k]);
+      }
+    }
+    res->termStart.push_back(res->termSlot.size());
+  }
+  return res;
+}
+
+void TruthTableSweeper::run(unsigned int count,
+                            const std::function<void(unsigned int)>& task) {
+  if (pool.get() && count > 1) {
+    pool->parallelFor(count, task);
+  } else {
+    for (unsigned int i = 0; i < count; i++) task(i);
+  }
+}
+
+unsigned int TruthTableSweeper::noRanges() {
+  if (!pool.get()) return 1;
+  return std::min<uint64_t>(noRows(), pool->size() * RANGES_PER_THREAD);
+}
+
+std::vector<double> TruthTableSweeper::readLeaves() {
+  CompiledNetwork& net = *network;
+  // the ends are read once here so the walkers never touch the graph
+  std::vector<double> res;
+  for (unsigned int i = net.numInputs; i < net.leaves.size(); i++) {
+    res.push_back(net.leaves[i]->outputValue(true));
+  }
+  return res;
+}
+
+void TruthTableSweeper::sync(Walker& walker, uint64_t assignment) {
+  CompiledNetwork& net = *network;
+  double falseValue = encoding == BIPOLAR_TRUTH ? -1 : 0;
+  for (unsigned int n = 0; n < bias.size(); n++) {
+    // the threshold of a step node is compared with the sum instead
+    walker.partial[n] = net.kind[n] == STEP_ACTIVATION ? 0 : bias[n];
+  }
+  for (unsigned int i = 0; i < net.numInputs; i++) {
+    double value = (assignment >> i) & 1 ? 1 : falseValue;
+    walker.slots[i] = value;
+    for (unsigned int e = inputStart[i]; e < inputStart[i + 1]; e++) {
+      walker.partial[inputNode[e]] += value * inputWeight[e];
+    }
+  }
+}
+
+void TruthTableSweeper::finish(Walker& walker) {
+  CompiledNetwork& net = *network;
+  double* slot = walker.slots.data() + net.leaves.size();
+
+  for (unsigned int g = 0; g < net.groupKind.size(); g++) {
+    unsigned int first = net.groupStart[g], last = net.groupStart[g + 1];
+    for (unsigned int n = first; n < last; n++) {
+      double value = walker.partial[n];
+      for (unsigned int e = termStart[n]; e < termStart[n + 1]; e++) {
+        value += walker.slots[termSlot[e]] * termWeight[e];
+      }
+      if (net.groupKind[g] == STEP_ACTIVATION) {
+        slot[n] = value >= bias[n] ? 1 : 0;
+      } else {
+        slot[n] = value;
+      }
+    }
+
+    if (net.groupKind[g] == SIGMOID_ACTIVATION) {
+      kernels::sigmoid(slot + first, last - first, net.accuracy);
+    } else if (net.groupKind[g] == BIPOLAR_ACTIVATION) {
+      kernels::bipolar(slot + first, last - first, net.beta[first], net.accuracy);
+    }
+  }
+
+  for (unsigned int o = 0; o < net.outputSource.size(); o++) {
+    int source = net.outputSource[o];
+    walker.output[o] = source < 0 ? 0 : walker.slots[source];
+  }
+}
+
+void TruthTableSweeper::walk(unsigned int range, unsigned int ranges,
+                             const std::vector<double>& leafValues,
+                             const RowFunction& row) {
+  CompiledNetwork& net = *network;
+  double falseValue = encoding == BIPOLAR_TRUTH ? -1 : 0;
+  uint64_t rows = noRows();
+  uint64_t first = range * (rows / ranges) + std::min<uint64_t>(range, rows % ranges);
+  uint64_t last = first + rows / ranges + (range < rows % ranges ? 1 : 0);
+
+  Walker walker;
+  walker.slots.resize(net.leaves.size() + net.noNodes());
+  walker.partial.resize(net.noNodes());
+  walker.output.resize(net.outputSource.size());
+  std::copy(leafValues.begin(), leafValues.end(), walker.slots.begin() + net.numInputs);
+
+  // the assignment at position i of the Gray code is i ^ (i >> 1)
+  uint64_t assignment = first ^ (first >> 1);
+  sync(walker, assignment);
+  for (uint64_t i = first; i < last; i++) {
+    if (i != first) {
+      // moving to position i flips the input of its lowest set bit
+      unsigned int input = std::countr_zero(i);
+      assignment ^= (uint64_t)1 << input;
+      if ((i - first) % SYNC_INTERVAL == 0) {
+        sync(walker, assignment);
+      } else {
+        double value = (assignment >> input) & 1 ? 1 : falseValue;
+        double change = value - walker.slots[input];
+        walker.slots[input] = value;
+        for (unsigned int e = inputStart[input]; e < inputStart[input + 1]; e++) {
+          walker.partial[inputNode[e]] += change * inputWeight[e];
+        }
+      }
+    }
+    finish(walker);
+    row(assignment, walker.output);
+  }
+}
+
+void TruthTableSweeper::sweep(const RowFunction& row) {
+  std::vector<double> leafValues = readLeaves();
+  unsigned int ranges = noRanges();
+  run(ranges, [&](unsigned int r) { walk(r, ranges, leafValues, row); });
+}
+
+std::vector<uint64_t> TruthTableSweeper::select(const RowPredicate& predicate) {
+  std::vector<double> leafValues = readLeaves();
+  unsigned int ranges = noRanges();
+  std::vector<std::vector<uint64_t> > found(ranges);
+  run(ranges, [&](unsigned int r) {
+    walk(r, ranges, leafValues, [&](uint64_t assignment, std::span<const double> output) {
+      if (predicate(assignment, output)) found[r].push_back(assignment);
+    });
+  });
+
+  std::vector<uint64_t> res;
+  for (unsigned int r = 0; r < ranges; r++) {
+    res.insert(res.end(), found[r].begin(), found[r].end());
+  }
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+}  // namespace neural
+}  // namespace nalso
@@ -0,0 +1,191 @@
+#pragma once
+/**
+ * @file sweeper.hh
+ *
+ * @brief Truth tables of networks with few inputs.
+ *
+ * Contains the declaration of a sweeper which evaluates a compiled network
+ * for every assignment of truth values to its inputs, visiting them in Gray
+ * code order so each step only changes one input.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "nalso/neural/compiled.hh"
+#include "nalso/neural/ternary.hh"
+#include "nalso/utils/threadpool.hh"
+
+namespace nalso {
+namespace neural {
+
+/**
+ * @brief Walks the truth table of a compiled network.
+ *
+ * The assignments of n inputs are numbered from 0 to 2^n - 1, input i being
+ * true when bit i of the number is set. They are visited in Gray code order,
+ * where consecutive assignments differ in a single input, so instead of
+ * computing the weighted sums of the nodes from scratch the sweeper keeps, for
+ * every node, the part of the sum contributed by the inputs and only adds the
+ * change of the input which flipped to the nodes reading it. The rest of the
+ * sum, which comes from other nodes, is computed as in the compiled network.
+ * The partial sums are computed again every SYNC_INTERVAL steps so the
+ * rounding errors of the updates do not build up.
+ *
+ * The Gray code is split in ranges evaluated by the threads of a pool, each
+ * with its own copy of the slots. The outputs may differ from those of
+ * CompiledNetwork::evaluate in the last bits, as the sums are added in a
+ * different order.
+ *
+ * The weights are read when the sweeper is built, so it has to be built again
+ * after training.
+ */
+class TruthTableSweeper {
+ public:
+  /** Largest number of inputs of a network whose table can be swept */
+  static const unsigned int MAX_INPUTS = 63;
+  /** Steps between two computations of the partial sums from scratch */
+  static const unsigned int SYNC_INTERVAL = 1024;
+  /** Ranges of the Gray code given to each thread of the pool */
+  static const unsigned int RANGES_PER_THREAD = 4;
+
+  /**
+   * Receives a row of the table, the number of the assignment and the value
+   * of each output, indexed by output port.
+   */
+  typedef std::function<void(uint64_t, std::span<const double>)> RowFunction;
+  /**
+   * Tells whether a row of the table, given as for RowFunction, is wanted.
+   */
+  typedef std::function<bool(uint64_t, std::span<const double>)> RowPredicate;
+
+ private:
+  CompiledNetworkPtr network;
+  TruthEncoding encoding;
+  utils::ThreadPoolPtr pool;
+
+  /**
+   * Input i is read with the weight inputWeight[e] by the node inputNode[e],
+   * for e in [inputStart[i], inputStart[i + 1]).
+   */
+  std::vector<unsigned int> inputStart;
+  std::vector<unsigned int> inputNode;
+  std::vector<double> inputWeight;
+
+  /**
+   * Node n reads the slots termSlot[e] which are not inputs with the weights
+   * termWeight[e], for e in [termStart[n], termStart[n + 1]).
+   */
+  std::vector<unsigned int> termStart;
+  std::vector<unsigned int> termSlot;
+  std::vector<double> termWeight;
+
+  /** Bias of each node, the threshold for step nodes */
+  std::vector<double> bias;
+
+  /** The slots and partial sums of one range of the Gray code */
+  struct Walker {
+    std::vector<double> slots;
+    std::vector<double> partial;
+    std::vector<double> output;
+  };
+
+  TruthTableSweeper() : encoding(BINARY_TRUTH) {}
+
+  /**
+   * Calls task(i) for every i in [0, count), in the threads of the pool if
+   * there is one.
+   */
+  void run(unsigned int count, const std::function<void(unsigned int)>& task);
+  /**
+   * Returns the number of ranges the Gray code is split in.
+   */
+  unsigned int noRanges();
+  /**
+   * Returns the values of the ends which are not inputs of the network.
+   */
+  std::vector<double> readLeaves();
+  /**
+   * Sets the inputs of a walker to an assignment and computes its partial
+   * sums from scratch.
+   */
+  void sync(Walker& walker, uint64_t assignment);
+  /**
+   * Computes the nodes from the partial sums and gathers the outputs.
+   */
+  void finish(Walker& walker);
+  /**
+   * Calls row for every assignment of one of the ranges of the Gray code.
+   *
+   * @param range The index of the range.
+   *
+   * @param ranges The number of ranges.
+   *
+   * @param leafValues The values of the ends which are not inputs.
+   *
+   * @param row Called once per assignment of the range.
+   */
+  void walk(unsigned int range, unsigned int ranges,
+            const std::vector<double>& leafValues, const RowFunction& row);
+
+ public:
+  /**
+   * Builds the sweeper of a compiled network.
+   *
+   * @param _network The compiled network.
+   *
+   * @param _encoding The numbers given to the inputs for false and true.
+   *
+   * @return A pointer to the sweeper or an empty pointer if the network has
+   * more than MAX_INPUTS inputs.
+   */
+  static std::shared_ptr<TruthTableSweeper> compile(
+      CompiledNetworkPtr _network, TruthEncoding _encoding = BINARY_TRUTH);
+
+  /**
+   * Evaluates the network for every assignment of its inputs. With a thread
+   * pool the rows are produced by all of its threads at once, so row must be
+   * safe to call concurrently, and in no particular order.
+   *
+   * @param row Called once per assignment.
+   */
+  void sweep(const RowFunction& row);
+
+  /**
+   * Finds the assignments whose outputs satisfy a predicate. With a thread
+   * pool the predicate must be safe to call concurrently.
+   *
+   * @param predicate Called once per assignment.
+   *
+   * @return The numbers of the assignments for which the predicate holds, in
+   * increasing order.
+   */
+  std::vector<uint64_t> select(const RowPredicate& predicate);
+
+  /**
+   * Sets the pool whose threads sweep the ranges of the Gray code. An empty
+   * pointer makes the sweep run in the calling thread only.
+   *
+   * @param _pool The thread pool to use.
+   */
+  void setThreadPool(utils::ThreadPoolPtr _pool) { pool = _pool; }
+
+  /**
+   * Returns the number of rows of the table.
+   *
+   * @return 2 to the number of inputs.
+   */
+  uint64_t noRows() { return (uint64_t)1 << network->noInputs(); }
+  CompiledNetworkPtr getNetwork() { return network; }
+  TruthEncoding getEncoding() { return encoding; }
+};
+
+typedef std::shared_ptr<TruthTableSweeper> TruthTableSweeperPtr;
+
+}  // namespace neural
+}  // namespace nalso
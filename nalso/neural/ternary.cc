@@ -0,0 +1,311 @@
+/**
+ * @file ternary.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "ternary.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NALSO_X86_POPCNT 1
+#endif
+
+namespace nalso {
+namespace neural {
+
+namespace {
+
+/**
+ * Propagates the truth values of the slots through the nodes, the body shared
+ * by the versions compiled with and without the popcnt instruction.
+ */
+__attribute__((always_inline)) inline void propagate(
+    uint64_t* slots, uint64_t* active, unsigned int base, unsigned int nodes,
+    const unsigned int* start, const unsigned int* word, const uint64_t* positive,
+    const uint64_t* negative, const int* threshold) {
+  for (unsigned int n = 0; n < nodes; n++) {
+    int d = 0;
+    for (unsigned int e = start[n]; e < start[n + 1]; e++) {
+      uint64_t w = slots[word[e]];
+      d += std::popcount(w & positive[e]) - std::popcount(w & negative[e]);
+    }
+    uint64_t on = d >= threshold[n];
+    slots[(base + n) / 64] |= on << ((base + n) % 64);
+    active[n / 64] |= on << (n % 64);
+  }
+}
+
+void propagateScalar(uint64_t* slots, uint64_t* active, unsigned int base,
+                     unsigned int nodes, const unsigned int* start,
+                     const unsigned int* word, const uint64_t* positive,
+                     const uint64_t* negative, const int* threshold) {
+  propagate(slots, active, base, nodes, start, word, positive, negative, threshold);
+}
+
+#ifdef NALSO_X86_POPCNT
+__attribute__((target("popcnt"))) void propagatePopcnt(
+    uint64_t* slots, uint64_t* active, unsigned int base, unsigned int nodes,
+    const unsigned int* start, const unsigned int* word, const uint64_t* positive,
+    const uint64_t* negative, const int* threshold) {
+  propagate(slots, active, base, nodes, start, word, positive, negative, threshold);
+}
+#endif
+
+typedef void (*PropagateFunction)(uint64_t*, uint64_t*, unsigned int, unsigned int,
+                                  const unsigned int*, const unsigned int*,
+                                  const uint64_t*, const uint64_t*, const int*);
+
+/**
+ * Returns the version of propagate for the processor, without the popcnt
+ * instruction std::popcount becomes a call into the runtime library.
+ */
+PropagateFunction bestPropagate() {
+#ifdef NALSO_X86_POPCNT
+  if (__builtin_cpu_supports("popcnt")) return propagatePopcnt;
+#endif
+  return propagateScalar;
+}
+
+}  // namespace
+
+TernaryNetworkPtr TernaryNetwork::compile(CompiledNetworkPtr _network,
+                                          TruthEncoding _encoding) {
+  TernaryNetworkPtr res(new TernaryNetwork);
+  CompiledNetwork& net = *_network;
+  unsigned int nodes = net.noNodes();
+  unsigned int base = net.leaves.size();
+  const double* weights = net.section(CompiledNetwork::WEIGHTS);
+
+  res->network = _network;
+  res->encoding = _encoding;
+  res->inputWords = (net.numInputs + 63) / 64;
+  res->nodeWords = (nodes + 63) / 64;
+  res->maskStart.push_back(0);
+
+  for (unsigned int n = 0; n < nodes; n++) {
+    const double* block = weights + net.weightOffset[n];
+    unsigned int first = net.rowStart[n], last = net.rowStart[n + 1];
+
+    // the masks of each word of the slots read by the node
+    std::map<unsigned int, std::pair<uint64_t, uint64_t> > masks;
+    double magnitude = 0;
+    int positives = 0, negatives = 0;
+    for (unsigned int e = first, k = 1; e < last; e++, k++) {
+      double weight = block[k];
+      if (weight == 0) continue;
+
+      unsigned int slot = net.column[e];
+      // the values of the ends which are not ports are unknown
+      if (slot >= net.numInputs && slot < base) return TernaryNetworkPtr();
+
+      if (magnitude == 0) {
+        magnitude = std::fabs(weight);
+      } else if (std::fabs(weight) != magnitude) {
+        return TernaryNetworkPtr();
+      }
+
+      uint64_t bit = (uint64_t)1 << (slot % 64);
+      std::pair<uint64_t, uint64_t>& mask = masks[slot / 64];
+      // a slot read twice would be counted once
+      if ((mask.first | mask.second) & bit) return TernaryNetworkPtr();
+      if (weight > 0) {
+        mask.first |= bit;
+        positives++;
+      } else {
+        mask.second |= bit;
+        negatives++;
+      }
+    }
+
+    for (auto it = masks.begin(); it != masks.end(); it++) {
+      res->maskWord.push_back((*it).first);
+      res->positive.push_back((*it).second.first);
+      res->negative.push_back((*it).second.second);
+    }
+    res->maskStart.push_back(res->maskWord.size());
+    res->magnitude.push_back(magnitude == 0 ? 1 : magnitude);
+    res->bias.push_back(block[0]);
+    res->offset.push_back(_encoding == BIPOLAR_TRUTH ? negatives - positives : 0);
+
+    // the smallest d in [-negatives, positives] for which the node is true,
+    // positives + 1 if there is none
+    int low = -negatives, high = positives + 1;
+    while (low < high) {
+      int middle = low + (high - low) / 2;
+      double value = res->sum(n, middle);
+      bool on = net.kind[n] == STEP_ACTIVATION ? value >= block[0] : value > 0;
+      if (on) {
+        high = middle;
+      } else {
+        low = middle + 1;
+      }
+    }
+    res->threshold.push_back(low);
+
+    // d >= low is the same as counting the true positive and the false
+    // negative inputs up to low + negatives, which never goes below zero
+    unsigned int width = 0;
+    while ((unsigned long)(positives + negatives) >> width) width++;
+    res->width.push_back(width);
+    res->bound.push_back((long)low + negatives);
+  }
+
+  res->bits.resize((base + nodes + 63) / 64);
+  res->planes.resize(base + nodes);
+  res->inputBits.resize(res->inputWords);
+  res->activeBits.resize(res->nodeWords);
+  return res;
+}
+
+double TernaryNetwork::sum(unsigned int node, int d) {
+  int scale = encoding == BIPOLAR_TRUTH ? 2 : 1;
+  double value = magnitude[node] * (scale * d + offset[node]);
+  return network->kind[node] == STEP_ACTIVATION ? value : bias[node] + value;
+}
+
+bool TernaryNetwork::isTrue(unsigned int slot, double value) {
+  unsigned int base = network->leaves.size();
+  if (slot < base) return encoding == BIPOLAR_TRUTH ? value > 0 : value > 0.5;
+  switch (network->kind[slot - base]) {
+    case SIGMOID_ACTIVATION:
+    case STEP_ACTIVATION:
+      return value > 0.5;
+    default:
+      return value > 0;
+  }
+}
+
+bool TernaryNetwork::crisp(std::span<const double> input) {
+  double falseValue = encoding == BIPOLAR_TRUTH ? -1 : 0;
+  for (unsigned int i = 0; i < network->numInputs; i++) {
+    if (input[i] != 1 && input[i] != falseValue) return false;
+  }
+  return true;
+}
+
+bool TernaryNetwork::query(std::span<const double> input,
+                           std::span<double> output) {
+  CompiledNetwork& net = *network;
+  unsigned int base = net.leaves.size();
+  double falseValue = encoding == BIPOLAR_TRUTH ? -1 : 0;
+
+  if (!crisp(input)) {
+    net.evaluate(input, output);
+    for (unsigned int o = 0; o < net.outputSource.size(); o++) {
+      int source = net.outputSource[o];
+      bool on = source >= 0 && isTrue(source, output[o]);
+      output[o] = on ? 1 : falseValue;
+    }
+    return false;
+  }
+
+  std::fill(inputBits.begin(), inputBits.end(), 0);
+  for (unsigned int i = 0; i < net.numInputs; i++) {
+    if (input[i] == 1) inputBits[i / 64] |= (uint64_t)1 << (i % 64);
+  }
+  evaluate(inputBits.data(), activeBits.data());
+
+  for (unsigned int o = 0; o < net.outputSource.size(); o++) {
+    int source = net.outputSource[o];
+    bool on;
+    if (source < 0) {
+      on = false;
+    } else if (source >= (int)base) {
+      on = (activeBits[(source - base) / 64] >> ((source - base) % 64)) & 1;
+    } else if (source < (int)net.numInputs) {
+      on = input[source] == 1;
+    } else {
+      on = isTrue(source, net.leaves[source]->outputValue(true));
+    }
+    output[o] = on ? 1 : falseValue;
+  }
+  return true;
+}
+
+void TernaryNetwork::evaluate(const uint64_t* truth, uint64_t* active) {
+  static const PropagateFunction function = bestPropagate();
+  std::fill(bits.begin(), bits.end(), 0);
+  std::copy_n(truth, inputWords, bits.begin());
+  // bits past the last input belong to the nodes
+  if (network->numInputs % 64) {
+    bits[inputWords - 1] &= ((uint64_t)1 << (network->numInputs % 64)) - 1;
+  }
+
+  std::fill_n(active, nodeWords, 0);
+  function(bits.data(), active, network->leaves.size(), threshold.size(),
+           maskStart.data(), maskWord.data(), positive.data(), negative.data(),
+           threshold.data());
+}
+
+void TernaryNetwork::evaluateBatch(std::span<const uint64_t> truth,
+                                   std::span<uint64_t> active, unsigned int rows) {
+  unsigned int inputs = network->numInputs;
+  unsigned int base = network->leaves.size();
+  unsigned int nodes = threshold.size();
+  uint64_t counter[64];
+
+  std::fill_n(active.begin(), (size_t)rows * nodeWords, 0);
+  for (unsigned int first = 0; first < rows; first += 64) {
+    unsigned int count = std::min(64u, rows - first);
+    uint64_t lanes = count == 64 ? ~(uint64_t)0 : ((uint64_t)1 << count) - 1;
+
+    std::fill(planes.begin(), planes.end(), 0);
+    for (unsigned int r = 0; r < count; r++) {
+      const uint64_t* row = truth.data() + (size_t)(first + r) * inputWords;
+      for (unsigned int w = 0; w < inputWords; w++) {
+        for (uint64_t x = row[w]; x; x &= x - 1) {
+          unsigned int i = w * 64 + std::countr_zero(x);
+          if (i < inputs) planes[i] |= (uint64_t)1 << r;
+        }
+      }
+    }
+
+    for (unsigned int n = 0; n < nodes; n++) {
+      uint64_t& out = planes[base + n];
+      long b = bound[n];
+      if (b <= 0 || b >> width[n]) {
+        out = b <= 0 ? lanes : 0;
+        continue;
+      }
+
+      std::fill_n(counter, width[n], 0);
+      for (unsigned int e = maskStart[n]; e < maskStart[n + 1]; e++) {
+        const uint64_t* word = planes.data() + maskWord[e] * 64;
+        for (int sign = 0; sign < 2; sign++) {
+          uint64_t negated = sign ? ~(uint64_t)0 : 0;
+          for (uint64_t m = sign ? negative[e] : positive[e]; m; m &= m - 1) {
+            uint64_t carry = word[std::countr_zero(m)] ^ negated;
+            for (unsigned int j = 0; j < width[n] && carry; j++) {
+              uint64_t next = counter[j] & carry;
+              counter[j] ^= carry;
+              carry = next;
+            }
+          }
+        }
+      }
+
+      // the lanes where counter - bound does not borrow
+      uint64_t borrow = 0;
+      for (unsigned int j = 0; j < width[n]; j++) {
+        borrow = (b >> j) & 1 ? ~counter[j] | borrow : ~counter[j] & borrow;
+      }
+      out = ~borrow & lanes;
+    }
+
+    for (unsigned int n = 0; n < nodes; n++) {
+      uint64_t bit = (uint64_t)1 << (n % 64);
+      for (uint64_t x = planes[base + n]; x; x &= x - 1) {
+        unsigned int r = first + std::countr_zero(x);
+        active[(size_t)r * nodeWords + n / 64] |= bit;
+      }
+    }
+  }
+}
+
+}  // namespace neural
+}  // namespace nalso
@@ -0,0 +1,294 @@
+/**
+ * @file trainer.cc
+ *
+ * @date Oct 16, 2026
+ */
+
+#include "trainer.hh"
+
+#include <atomic>
+#include <numeric>
+
+namespace nalso {
+namespace neural {
+
+namespace {
+
+/**
+ * Derivative of the activation function of the given kind expressed in terms
+ * of the value of the node.
+ */
+inline double derivative(int kind, double value, double beta) {
+  switch (kind) {
+    case SIGMOID_ACTIVATION:
+      return value * (1 - value);
+    case BIPOLAR_ACTIVATION:
+      return beta * (1 + value) * (1 - value) / 2;
+    case STEP_ACTIVATION:
+      return 0;
+    default:
+      return 1;
+  }
+}
+
+/** Number of weights reduced and updated by each iteration of update, a
+ * multiple of a cache line */
+const unsigned int UPDATE_CHUNK = 1024;
+
+}  // namespace
+
+bool Dataset::addExample(std::span<const double> input,
+                         std::span<const double> target) {
+  if (input.size() != numInputs || target.size() != numOutputs) return false;
+  inputs.insert(inputs.end(), input.begin(), input.end());
+  targets.insert(targets.end(), target.begin(), target.end());
+  return true;
+}
+
+Trainer::Trainer(CompiledNetworkPtr _network, double _learning,
+                 double _momentum)
+    : network(_network),
+      batchSize(1),
+      shuffle(true),
+      hogwild(false),
+      sharedWeights(false) {
+  setOptimizer(OptimizerPtr(new MomentumSgd(_learning, _momentum)));
+}
+
+Trainer::Trainer(CompiledNetworkPtr _network, OptimizerPtr _optimizer)
+    : network(_network),
+      batchSize(1),
+      shuffle(true),
+      hogwild(false),
+      sharedWeights(false) {
+  setOptimizer(_optimizer);
+}
+
+void Trainer::run(unsigned int count,
+                  const std::function<void(unsigned int)>& task) {
+  if (pool.get() && count > 1) {
+    pool->parallelFor(count, task);
+  } else {
+    for (unsigned int i = 0; i < count; i++) task(i);
+  }
+}
+
+bool Trainer::prepare(const Dataset& data) {
+  CompiledNetwork& net = *network;
+  if (data.noInputs() != net.noInputs() || data.noOutputs() != net.noOutputs()) {
+    return false;
+  }
+
+  // another trainer sharing the optimiser may have detached it
+  optimizer->attach(net);
+
+  workers.resize(pool.get() ? pool->size() : 1);
+  for (unsigned int w = 0; w < workers.size(); w++) {
+    workers[w].slots.resize(net.values.size());
+    workers[w].errors.resize(net.noNodes());
+    workers[w].gradient.resize(net.getSectionSize());
+    workers[w].squared = 0;
+  }
+
+  // the ends are read once here so the workers never touch the graph
+  leafValues.resize(net.leaves.size());
+  for (unsigned int i = net.numInputs; i < net.leaves.size(); i++) {
+    leafValues[i] = net.leaves[i]->outputValue(true);
+  }
+  return true;
+}
+
+void Trainer::forward(Worker& worker, const Dataset& data,
+                      unsigned int example) {
+  CompiledNetwork& net = *network;
+  std::span<const double> input = data.input(example);
+  std::copy(input.begin(), input.end(), worker.slots.begin());
+  std::copy(leafValues.begin() + net.numInputs, leafValues.end(),
+            worker.slots.begin() + net.numInputs);
+  net.forward(worker.slots.data(), 0, net.groupKind.size(), sharedWeights);
+}
+
+void Trainer::backward(Worker& worker, const Dataset& data,
+                       unsigned int example) {
+  CompiledNetwork& net = *network;
+  double* weights = net.section(CompiledNetwork::WEIGHTS);
+  unsigned int base = net.leaves.size();
+  std::span<const double> target = data.target(example);
+  std::vector<double>& slots = worker.slots;
+  std::vector<double>& errors = worker.errors;
+  std::vector<double>& gradient = worker.gradient;
+
+  forward(worker, data, example);
+
+  std::fill(errors.begin(), errors.end(), 0);
+  for (unsigned int o = 0; o < target.size(); o++) {
+    int source = net.outputSource[o];
+    double error = target[o] - (source < 0 ? 0 : slots[source]);
+    worker.squared += error * error;
+    // output ends pass their value through, so their error reaches the node
+    if (source >= (int)base) errors[source - base] += error;
+  }
+
+  // the nodes are visited backwards so the error of a node is complete before
+  // it is propagated to its inputs
+  for (unsigned int n = net.noNodes(); n-- > 0;) {
+    double error = errors[n] * derivative(net.kind[n], slots[base + n], net.beta[n]);
+    if (error == 0) continue;
+
+    unsigned int offset = net.weightOffset[n];
+    gradient[offset] += error;
+    for (unsigned int e = net.rowStart[n], k = 1; e < net.rowStart[n + 1]; e++, k++) {
+      unsigned int input = net.column[e];
+      gradient[offset + k] += error * slots[input];
+      if (input < base) continue;
+      // other workers may be storing this weight in Hogwild mode
+      double weight = sharedWeights ? std::atomic_ref<double>(weights[offset + k])
+                                          .load(std::memory_order_relaxed)
+                                    : weights[offset + k];
+      errors[input - base] += error * weight;
+    }
+  }
+}
+
+void Trainer::update(unsigned int shards, unsigned int count) {
+  double* gradient = workers[0].gradient.data();
+  double scale = 1.0 / count;
+  unsigned int size = network->getSectionSize();
+  unsigned int chunks = (size + UPDATE_CHUNK - 1) / UPDATE_CHUNK;
+
+  optimizer->beginBatch();
+  run(chunks, [&](unsigned int chunk) {
+    unsigned int first = chunk * UPDATE_CHUNK;
+    unsigned int last = std::min(size, first + UPDATE_CHUNK);
+    for (unsigned int i = first; i < last; i++) {
+      double sum = gradient[i];
+      for (unsigned int w = 1; w < shards; w++) sum += workers[w].gradient[i];
+      gradient[i] = sum * scale;
+    }
+    optimizer->update(gradient, first, last);
+  });
+}
+
+void Trainer::updateHogwild(Worker& worker, unsigned int count) {
+  double scale = 1.0 / count;
+  for (unsigned int i = 0; i < worker.gradient.size(); i++) {
+    worker.gradient[i] *= scale;
+  }
+  optimizer->updateShared(worker.gradient.data(), 0, worker.gradient.size());
+}
+
+double Trainer::trainEpoch(const Dataset& data) {
+  if (!prepare(data)) return -1;
+
+  unsigned int size = data.size();
+  if (order.size() != size) {
+    order.resize(size);
+    std::iota(order.begin(), order.end(), 0);
+  }
+  if (shuffle) std::shuffle(order.begin(), order.end(), generator);
+
+  if (hogwild && optimizer->lockFree() && workers.size() > 1) {
+    unsigned int shards = workers.size();
+    sharedWeights = true;
+    run(shards, [&](unsigned int s) {
+      Worker& worker = workers[s];
+      unsigned int last = size * (s + 1) / shards;
+      for (unsigned int first = size * s / shards; first < last; first += batchSize) {
+        unsigned int count = std::min(batchSize, last - first);
+        std::fill(worker.gradient.begin(), worker.gradient.end(), 0);
+        for (unsigned int i = first; i < first + count; i++) {
+          backward(worker, data, order[i]);
+        }
+        updateHogwild(worker, count);
+      }
+    });
+    sharedWeights = false;
+  } else {
+    for (unsigned int first = 0; first < size; first += batchSize) {
+      unsigned int count = std::min(batchSize, size - first);
+      unsigned int shards = std::min((unsigned int)workers.size(), count);
+      run(shards, [&](unsigned int s) {
+        Worker& worker = workers[s];
+        std::fill(worker.gradient.begin(), worker.gradient.end(), 0);
+        unsigned int last = first + count * (s + 1) / shards;
+        for (unsigned int i = first + count * s / shards; i < last; i++) {
+          backward(worker, data, order[i]);
+        }
+      });
+      update(shards, count);
+    }
+  }
+  network->weightsChanged();
+
+  double squared = 0;
+  for (unsigned int w = 0; w < workers.size(); w++) squared += workers[w].squared;
+  return size && data.noOutputs() ? squared / (size * data.noOutputs()) : 0;
+}
+
+double Trainer::train(const Dataset& data, unsigned int epochs) {
+  double mse = 0;
+  for (unsigned int i = 0; i < epochs; i++) {
+    mse = trainEpoch(data);
+    if (mse < 0) return mse;
+  }
+  network->writeBack();
+  return mse;
+}
+
+double Trainer::error(const Dataset& data) {
+  if (!prepare(data)) return -1;
+
+  unsigned int size = data.size();
+  unsigned int shards = std::min((unsigned int)workers.size(), size);
+  run(shards, [&](unsigned int s) {
+    Worker& worker = workers[s];
+    unsigned int last = size * (s + 1) / shards;
+    for (unsigned int i = size * s / shards; i < last; i++) {
+      forward(worker, data, i);
+      std::span<const double> target = data.target(i);
+      for (unsigned int o = 0; o < target.size(); o++) {
+        int source = network->outputSource[o];
+        double error = target[o] - (source < 0 ? 0 : worker.slots[source]);
+        worker.squared += error * error;
+      }
+    }
+  });
+
+  double squared = 0;
+  for (unsigned int w = 0; w < workers.size(); w++) squared += workers[w].squared;
+  return size && data.noOutputs() ? squared / (size * data.noOutputs()) : 0;
+}
+
+double EarlyStopping::train(const Dataset& data, const Dataset& validation,
+                            unsigned int maxEpochs) {
+  CompiledNetworkPtr network = trainer->getNetwork();
+  epochs = 0;
+  bestEpoch = 0;
+  bestError = trainer->error(validation);
+  if (bestError < 0) return bestError;
+  network->saveWeights();
+
+  unsigned int failures = 0;
+  while (epochs < maxEpochs && failures < patience) {
+    for (unsigned int i = 0; i < interval && epochs < maxEpochs; i++, epochs++) {
+      if (trainer->trainEpoch(data) < 0) return -1;
+    }
+
+    double error = trainer->error(validation);
+    if (error < bestError - minDelta) {
+      bestError = error;
+      bestEpoch = epochs;
+      network->saveWeights();
+      failures = 0;
+    } else {
+      failures++;
+    }
+  }
+
+  network->restoreWeights();
+  network->writeBack();
+  return bestError;
+}
+
+}  // namespace neural
+}  // namespace nalso
@@ -0,0 +1,394 @@
+#pragma once
+/**
+ * @file trainer.hh
+ *
+ * @brief Backpropagation training of compiled feed forward networks.
+ *
+ * Contains the declaration of the dataset used to train a network and of the
+ * mini-batch gradient descent trainer which works directly over the arrays of
+ * a CompiledNetwork.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "nalso/neural/compiled.hh"
+#include "nalso/neural/optimizer.hh"
+#include "nalso/utils/threadpool.hh"
+
+namespace nalso {
+namespace neural {
+
+/**
+ * @brief A set of labelled examples.
+ *
+ * The inputs and the expected outputs of the examples are stored as two row
+ * major matrices, one row per example, indexed by the input and output ports
+ * of the network.
+ */
+class Dataset {
+ private:
+  unsigned int numInputs;
+  unsigned int numOutputs;
+  std::vector<double> inputs;
+  std::vector<double> targets;
+
+ public:
+  /**
+   * Creates an empty dataset.
+   *
+   * @param _numInputs The number of input values of every example.
+   *
+   * @param _numOutputs The number of expected output values of every example.
+   */
+  Dataset(unsigned int _numInputs, unsigned int _numOutputs)
+      : numInputs(_numInputs), numOutputs(_numOutputs) {}
+
+  /**
+   * Adds an example to the dataset.
+   *
+   * @param input The value of each input, indexed by input port.
+   *
+   * @param target The expected value of each output, indexed by output port.
+   *
+   * @return false if the sizes of the vectors do not match the dataset.
+   */
+  bool addExample(std::span<const double> input, std::span<const double> target);
+
+  /**
+   * Returns the inputs of an example.
+   *
+   * @param index The position of the example.
+   *
+   * @return noInputs() values indexed by input port.
+   */
+  std::span<const double> input(unsigned int index) const {
+    return std::span<const double>(inputs.data() + index * numInputs, numInputs);
+  }
+  /**
+   * Returns the expected outputs of an example.
+   *
+   * @param index The position of the example.
+   *
+   * @return noOutputs() values indexed by output port.
+   */
+  std::span<const double> target(unsigned int index) const {
+    return std::span<const double>(targets.data() + index * numOutputs, numOutputs);
+  }
+
+  /**
+   * Returns the number of examples.
+   *
+   * @return the number of examples in the dataset.
+   */
+  unsigned int size() const { return targets.size() / std::max(numOutputs, 1u); }
+  /**
+   * Returns the number of inputs of each example.
+   *
+   * @return the number of inputs.
+   */
+  unsigned int noInputs() const { return numInputs; }
+  /**
+   * Returns the number of expected outputs of each example.
+   *
+   * @return the number of outputs.
+   */
+  unsigned int noOutputs() const { return numOutputs; }
+};
+
+/**
+ * @brief Mini-batch backpropagation over a compiled network.
+ *
+ * The gradient of every example is computed with a forward loop followed by a
+ * reverse loop over the same index arrays, accumulating the error of each
+ * node in a flat array instead of following the output connections of the
+ * graph. The gradients of a batch are averaged and handed to an Optimizer,
+ * by default the momentum rule used by NeuralMethod::updateWeights.
+ *
+ * The error minimised is the squared error of the outputs. Step nodes are not
+ * differentiable, so their weights are left untouched and no error flows
+ * through them.
+ */
+class Trainer {
+ private:
+  /**
+   * State private to the thread working on a shard of a batch, aligned to a
+   * cache line so the squared errors of two workers never share one
+   */
+  struct alignas(64) Worker {
+    /** Value of every slot for the current example */
+    std::vector<double> slots;
+    /** Error of every node of the plan for the current example */
+    std::vector<double> errors;
+    /** Sum of the gradients of the shard, laid out as a section of the arena */
+    std::vector<double> gradient;
+    /** Squared error of the examples seen by the worker */
+    double squared;
+  };
+
+  CompiledNetworkPtr network;
+  OptimizerPtr optimizer;
+  unsigned int batchSize;
+  bool shuffle;
+  bool hogwild;
+  /** Whether the workers are updating the weights while others read them */
+  bool sharedWeights;
+  std::mt19937 generator;
+  utils::ThreadPoolPtr pool;
+
+  /** Order in which the examples are visited during an epoch */
+  std::vector<unsigned int> order;
+  /** Value of the input ends which are not ports of the network */
+  std::vector<double> leafValues;
+  /** One worker per thread of the pool */
+  std::vector<Worker> workers;
+
+  /**
+   * Calls task(i) for every i in [0, count), in the threads of the pool if
+   * there is one.
+   */
+  void run(unsigned int count, const std::function<void(unsigned int)>& task);
+  /**
+   * Runs the forward loop for an example and leaves the value of every slot in
+   * the slots of the worker.
+   */
+  void forward(Worker& worker, const Dataset& data, unsigned int example);
+  /**
+   * Computes the gradient of the squared error of an example and adds it to
+   * the gradient of the worker.
+   */
+  void backward(Worker& worker, const Dataset& data, unsigned int example);
+  /**
+   * Sums the gradients of the first shards workers and passes the average to
+   * the optimiser, splitting the arena among the threads of the pool.
+   *
+   * @param shards The number of workers which took part in the batch.
+   *
+   * @param count The number of examples in the batch.
+   */
+  void update(unsigned int shards, unsigned int count);
+  /**
+   * Passes the averaged gradient of a single worker to the optimiser, which
+   * updates the shared weights without any locking.
+   *
+   * @param worker The worker holding the gradient.
+   *
+   * @param count The number of examples the gradient was computed from.
+   */
+  void updateHogwild(Worker& worker, unsigned int count);
+  /**
+   * Tells whether the dataset can be used with the network and prepares the
+   * buffers of the workers.
+   */
+  bool prepare(const Dataset& data);
+
+ public:
+  /**
+   * Creates a trainer for a compiled network which uses gradient descent with
+   * momentum.
+   *
+   * @param _network The plan whose weights are trained.
+   *
+   * @param _learning The learning rate.
+   *
+   * @param _momentum The fraction of the last change added to each update.
+   */
+  Trainer(CompiledNetworkPtr _network, double _learning = 0.3,
+          double _momentum = 0.2);
+  /**
+   * Creates a trainer for a compiled network which uses the given optimiser.
+   *
+   * @param _network The plan whose weights are trained.
+   *
+   * @param _optimizer The rule used to update the weights after each batch.
+   */
+  Trainer(CompiledNetworkPtr _network, OptimizerPtr _optimizer);
+  /**
+   * Releases the state of the optimiser from the network.
+   */
+  ~Trainer() { optimizer->detach(); }
+
+  /**
+   * Sets the number of examples whose gradients are averaged before updating
+   * the weights. A size of 1 gives plain online backpropagation.
+   *
+   * @param size The number of examples per batch, at least 1.
+   */
+  void setBatchSize(unsigned int size) { batchSize = std::max(size, 1u); }
+  /**
+   * Tells whether the examples are visited in a different random order on
+   * each epoch.
+   *
+   * @param _shuffle true to shuffle the examples.
+   */
+  void setShuffle(bool _shuffle) { shuffle = _shuffle; }
+  /**
+   * Seeds the generator used to shuffle the examples.
+   *
+   * @param seed The seed.
+   */
+  void setSeed(unsigned int seed) { generator.seed(seed); }
+  /**
+   * Sets the pool used to train in parallel. Each batch is split in one shard
+   * per thread, the gradients of each shard are accumulated privately and
+   * reduced into the weight arena once per batch, so the result matches a
+   * single thread up to the rounding of the sums. An empty pointer makes the
+   * trainer run in the calling thread only.
+   *
+   * @param _pool The thread pool to use.
+   */
+  void setThreadPool(utils::ThreadPoolPtr _pool) { pool = _pool; }
+  /**
+   * Enables the Hogwild mode: every thread of the pool trains over its own
+   * shard of the epoch and applies its batches to the shared weights as soon
+   * as they are done, without locks. The weights are read and written
+   * through relaxed atomics, so the threads see the changes of the others
+   * in no particular order and an update which collides with another one
+   * may be lost. That works well for sparse networks where updates seldom
+   * collide, but the result depends on the scheduling of the threads. It is
+   * ignored when the optimiser is not lock free.
+   *
+   * @param _hogwild true to update the weights without synchronisation.
+   */
+  void setHogwild(bool _hogwild) { hogwild = _hogwild; }
+  /**
+   * Sets the rule used to update the weights after each batch. Its state is
+   * allocated in the weight arena of the network, and the state of the
+   * previous optimiser is released.
+   *
+   * @param _optimizer The optimiser to use.
+   */
+  void setOptimizer(OptimizerPtr _optimizer) {
+    if (optimizer.get() && optimizer != _optimizer) optimizer->detach();
+    optimizer = _optimizer;
+    optimizer->attach(*network);
+  }
+  OptimizerPtr getOptimizer() { return optimizer; }
+  CompiledNetworkPtr getNetwork() { return network; }
+
+  /**
+   * Goes once over every example of the dataset, updating the weights after
+   * each batch.
+   *
+   * @param data The examples, whose sizes must match the network.
+   *
+   * @return The mean squared error of the outputs seen during the epoch, or
+   * -1 if the dataset does not match the network.
+   */
+  double trainEpoch(const Dataset& data);
+
+  /**
+   * Trains the network for a number of epochs and copies the resulting
+   * weights back into the nodes of the graph.
+   *
+   * @param data The examples, whose sizes must match the network.
+   *
+   * @param epochs The number of passes over the dataset.
+   *
+   * @return The mean squared error of the last epoch, or -1 if the dataset
+   * does not match the network.
+   */
+  double train(const Dataset& data, unsigned int epochs);
+
+  /**
+   * Computes the mean squared error of the network over a dataset without
+   * changing the weights.
+   *
+   * @param data The examples, whose sizes must match the network.
+   *
+   * @return The mean squared error of the outputs, or -1 if the dataset does
+   * not match the network.
+   */
+  double error(const Dataset& data);
+};
+
+typedef std::shared_ptr<Trainer> TrainerPtr;
+
+/**
+ * @brief Trains a network while it keeps improving on a held out dataset.
+ *
+ * Every few epochs the error over a validation set is measured. When it is
+ * the lowest seen so far the weights are saved into the BEST_WEIGHTS section
+ * of the arena, and once a number of validations in a row fail to improve on
+ * it training stops. The best weights are restored and copied back into the
+ * graph at the end.
+ */
+class EarlyStopping {
+ private:
+  TrainerPtr trainer;
+  unsigned int interval;
+  unsigned int patience;
+  double minDelta;
+
+  unsigned int epochs;
+  unsigned int bestEpoch;
+  double bestError;
+
+ public:
+  /**
+   * @param _trainer The trainer used for each epoch.
+   *
+   * @param _interval The number of epochs between two validations.
+   *
+   * @param _patience The number of validations in a row without improvement
+   * after which training stops.
+   *
+   * @param _minDelta The amount by which the validation error must decrease to
+   * count as an improvement.
+   */
+  EarlyStopping(TrainerPtr _trainer, unsigned int _interval = 1,
+                unsigned int _patience = 10, double _minDelta = 0)
+      : trainer(_trainer),
+        interval(std::max(_interval, 1u)),
+        patience(std::max(_patience, 1u)),
+        minDelta(_minDelta),
+        epochs(0),
+        bestEpoch(0),
+        bestError(-1) {}
+
+  /**
+   * Trains until the validation error stops improving or the maximum number
+   * of epochs is reached, and leaves the network with the weights that gave
+   * the lowest validation error.
+   *
+   * @param data The examples to train on.
+   *
+   * @param validation The held out examples used to choose the weights.
+   *
+   * @param maxEpochs The maximum number of epochs to train.
+   *
+   * @return The lowest validation error, or -1 if a dataset does not match
+   * the network.
+   */
+  double train(const Dataset& data, const Dataset& validation,
+               unsigned int maxEpochs);
+
+  /**
+   * Returns the number of epochs run by the last call to train.
+   *
+   * @return the number of epochs.
+   */
+  unsigned int getEpochs() { return epochs; }
+  /**
+   * Returns the epoch after which the best weights were saved, 0 if the
+   * initial weights were never improved upon.
+   *
+   * @return the epoch of the best weights.
+   */
+  unsigned int getBestEpoch() { return bestEpoch; }
+  /**
+   * Returns the validation error of the best weights.
+   *
+   * @return the lowest validation error.
+   */
+  double getBestError() { return bestError; }
+};
+
+}  // namespace neural
+}  // namespace nalso
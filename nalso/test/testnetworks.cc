@@ -80,7 +80,829 @@ void TestNeuralNetworks::testFeedForwardNeuralNetwork() {
   CPPUNIT_ASSERT(par2["w0-pxq"] > 0.5);
 }
 
-void TestNeuralNetworks::testFixPointOperatorFeedForward() {}
+void TestNeuralNetworks::testFixPointOperatorFeedForward() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr bip(new BipolarSemilinearMethod(1));
+
+  // p is a fact, q :- p and r :- not q, each atom with an input and an output
+  FeedForwardNeuralNetwork network;
+  const char* atoms[] = {"p", "q", "r"};
+  for (int i = 0; i < 3; i++) {
+    NeuralNodePtr input(new NeuralNode(string(atoms[i]) + "_i", lin));
+    (*input).setType(INPUT);
+    network.addNode(input);
+    NeuralNodePtr output(new NeuralNode(string(atoms[i]) + "_o", bip));
+    (*output).setType(OUTPUT);
+    // the fact p makes its output true whatever the inputs
+    if (i == 0) (*output).setBias(2);
+    network.addNode(output);
+  }
+  network.connectNodes("p_i", "q_o", 4);
+  network.connectNodes("q_i", "r_o", -4);
+
+  // the suffixes are dropped so each output feeds the input of its atom
+  CPPUNIT_ASSERT(network.inputPort("w0-p") == 0);
+  CPPUNIT_ASSERT(network.outputPort("w0-p") == 0);
+  vector<int> feedback = network.feedbackPorts();
+  CPPUNIT_ASSERT(feedback.size() == 3);
+  for (int i = 0; i < 3; i++) CPPUNIT_ASSERT(feedback[i] == i);
+
+  ParamsMap start;
+  for (int i = 0; i < 3; i++) start[string("w0-") + atoms[i]] = -1;
+  ParamsMap recursive = network.NeuralNetwork::findFixPoint(start, 1e-9);
+  CPPUNIT_ASSERT(network.compile());
+  ParamsMap fixpoint = network.findFixPoint(start, 1e-9);
+  CPPUNIT_ASSERT(fixpoint["w0-p"] > 0);
+  CPPUNIT_ASSERT(fixpoint["w0-q"] > 0);
+  CPPUNIT_ASSERT(fixpoint["w0-r"] < 0);
+  CPPUNIT_ASSERT(NeuralNetwork::areEqualParameters(fixpoint, recursive, 1e-8));
+
+  // the engine iterates buffers indexed by port
+  RecurrentNetworkPtr recurrent =
+      RecurrentNetwork::compile(network.getCompiled(), feedback);
+  CPPUNIT_ASSERT(recurrent.get());
+  vector<double> in(3, -1), out(3);
+  FixPointResult result = recurrent->findFixPoint(in, out, 1e-9);
+  CPPUNIT_ASSERT(result.status == CONVERGED_STATUS);
+  CPPUNIT_ASSERT(result.iterations > 2);
+  CPPUNIT_ASSERT(fabs(out[1] - fixpoint["w0-q"]) < 1e-12);
+  CPPUNIT_ASSERT(!RecurrentNetwork::compile(network.getCompiled(), vector<int>(2, 0)).get());
+
+  // the engine of the network is kept between calls and built again once the
+  // weights change, here into q :- not p, which makes r true
+  ParamsMap again = network.findFixPoint(start, 1e-9);
+  CPPUNIT_ASSERT(NeuralNetwork::areEqualParameters(again, fixpoint, 1e-12));
+  CompiledNetworkPtr compiled = network.getCompiled();
+  double* weights = compiled->section(CompiledNetwork::WEIGHTS);
+  for (unsigned int i = 0; i < compiled->getSectionSize(); i++) {
+    if (weights[i] == 4) weights[i] = -4;
+  }
+  compiled->weightsChanged();
+  again = network.findFixPoint(start, 1e-9);
+  CPPUNIT_ASSERT(again["w0-q"] < 0 && again["w0-r"] > 0);
+}
+
+void TestNeuralNetworks::testFixPointBudget() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr bip(new BipolarSemilinearMethod(1));
+
+  // p :- not p has no stable model, its network flips p at every iteration
+  FeedForwardNeuralNetwork network;
+  NeuralNodePtr input(new NeuralNode("p_i", lin));
+  (*input).setType(INPUT);
+  network.addNode(input);
+  NeuralNodePtr output(new NeuralNode("p_o", bip));
+  (*output).setType(OUTPUT);
+  network.addNode(output);
+  network.connectNodes("p_i", "p_o", -4);
+
+  ParamsMap start;
+  start["w0-p"] = -1;
+  FixPointResult result;
+  ParamsMap last = network.NeuralNetwork::findFixPoint(start, 1e-9, FixPointBudget(), &result);
+  CPPUNIT_ASSERT(result.status == OSCILLATING_STATUS);
+  CPPUNIT_ASSERT(result.period == 2);
+  CPPUNIT_ASSERT(result.iterations < FixPointBudget::DEFAULT_MAX_ITERATIONS);
+  CPPUNIT_ASSERT(last.size() == 1);
+
+  CPPUNIT_ASSERT(network.compile());
+  network.findFixPoint(start, 1e-9, FixPointBudget(), &result);
+  CPPUNIT_ASSERT(result.status == OSCILLATING_STATUS);
+  CPPUNIT_ASSERT(result.period == 2);
+
+  // without a history the cycle is only stopped by the budget
+  network.findFixPoint(start, 1e-9, FixPointBudget(5, 0, 0), &result);
+  CPPUNIT_ASSERT(result.status == EXHAUSTED_STATUS);
+  CPPUNIT_ASSERT(result.iterations == 5);
+  network.findFixPoint(start, 1e-9, FixPointBudget(0, 1e-3, 0), &result);
+  CPPUNIT_ASSERT(result.status == EXHAUSTED_STATUS);
+
+  // states within the tolerance close a cycle even when they round apart
+  FixPointMonitor monitor(FixPointBudget(), 0.1);
+  double states[][1] = {{0.149}, {0.5}, {0.151}};
+  CPPUNIT_ASSERT(monitor.proceed(states[0]) && monitor.proceed(states[1]));
+  CPPUNIT_ASSERT(!monitor.proceed(states[2]));
+  CPPUNIT_ASSERT(monitor.getResult().status == OSCILLATING_STATUS);
+  CPPUNIT_ASSERT(monitor.getResult().period == 2);
+}
+
+void TestNeuralNetworks::testAsynchronousFixPoint() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr bip(new BipolarSemilinearMethod(1));
+
+  // a9 is a fact and a(i) :- a(i + 1), so the ports go against the chain
+  FeedForwardNeuralNetwork network;
+  for (int i = 0; i < 10; i++) {
+    stringstream name;
+    name << "a" << i;
+    NeuralNodePtr input(new NeuralNode(name.str() + "_i", lin));
+    (*input).setType(INPUT);
+    network.addNode(input);
+    NeuralNodePtr output(new NeuralNode(name.str() + "_o", bip));
+    (*output).setType(OUTPUT);
+    if (i == 9) (*output).setBias(4);
+    network.addNode(output);
+  }
+  for (int i = 0; i < 9; i++) {
+    stringstream source, dest;
+    source << "a" << i + 1 << "_i";
+    dest << "a" << i << "_o";
+    network.connectNodes(source.str(), dest.str(), 4);
+  }
+  CPPUNIT_ASSERT(network.compile());
+
+  RecurrentNetworkPtr recurrent =
+      RecurrentNetwork::compile(network.getCompiled(), network.feedbackPorts());
+  const vector<unsigned int>& order = recurrent->getOrder();
+  CPPUNIT_ASSERT(order.size() == 10);
+  for (int i = 0; i < 10; i++) CPPUNIT_ASSERT(order[i] == (unsigned int)(9 - i));
+
+  vector<double> in(10, -1), jacobi(10), seidel(10);
+  FixPointResult synchronous = recurrent->findFixPoint(in, jacobi, 1e-9);
+  recurrent->setUpdateMode(ASYNCHRONOUS_UPDATE);
+  FixPointResult asynchronous = recurrent->findFixPoint(in, seidel, 1e-9);
+  CPPUNIT_ASSERT(synchronous.status == CONVERGED_STATUS);
+  CPPUNIT_ASSERT(asynchronous.status == CONVERGED_STATUS);
+  // the truth of a9 reaches a0 within the first sweep
+  CPPUNIT_ASSERT(synchronous.iterations > 10);
+  CPPUNIT_ASSERT(asynchronous.iterations < synchronous.iterations);
+  for (int i = 0; i < 10; i++) {
+    CPPUNIT_ASSERT(seidel[i] > 0);
+    CPPUNIT_ASSERT(fabs(seidel[i] - jacobi[i]) < 1e-8);
+  }
+
+  // the order must list every fed port once
+  CPPUNIT_ASSERT(!recurrent->setOrder(vector<unsigned int>(10, 0)));
+  vector<unsigned int> forward(10);
+  for (int i = 0; i < 10; i++) forward[i] = i;
+  CPPUNIT_ASSERT(recurrent->setOrder(forward));
+}
+
+void TestNeuralNetworks::testCompiledFeedForward() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr sig(new SigmoidMethod);
+  NeuralMethodPtr bip(new BipolarSemilinearMethod(2));
+
+  NeuralNodePtr nnp(new NeuralNode("p", lin));
+  (*nnp).setType(INPUT);
+  NeuralNodePtr nnq(new NeuralNode("q", lin));
+  (*nnq).setType(INPUT);
+  NeuralNodePtr nnpxq(new NeuralNode("pxq", sig));
+  (*nnpxq).setType(OUTPUT);
+  NeuralNodePtr h0(new NeuralNode("h0", bip));
+  (*h0).setBias(0.5);
+  NeuralNodePtr h1(new NeuralNode("h1", sig));
+  (*h1).setBias(-0.5);
+
+  FeedForwardNeuralNetwork network;
+  network.addNode(nnp);
+  network.addNode(nnq);
+  network.addNode(h0);
+  network.addNode(h1);
+  network.addNode(nnpxq);
+
+  network.connectNodes("p", "h0", 3);
+  network.connectNodes("p", "h1", 2);
+  network.connectNodes("q", "h0", -3);
+  network.connectNodes("q", "h1", -2);
+  network.connectNodes("h0", "pxq", 3);
+  network.connectNodes("h1", "pxq", -3);
+
+  vector<ParamsMap> questions, answers;
+  for (int p = 0; p < 2; p++) {
+    for (int q = 0; q < 2; q++) {
+      ParamsMap question;
+      question["w0-p"] = p;
+      question["w0-q"] = q;
+      questions.push_back(question);
+      answers.push_back(network.evaluate(question));
+    }
+  }
+
+  CPPUNIT_ASSERT(network.compile());
+  CPPUNIT_ASSERT(network.getCompiled()->noNodes() == 5);
+  // the inputs, the bipolar and the sigmoid hidden nodes, and the output
+  CPPUNIT_ASSERT(network.getCompiled()->noGroups() == 4);
+  for (unsigned int i = 0; i < questions.size(); i++) {
+    ParamsMap res = network.evaluate(questions[i]);
+    CPPUNIT_ASSERT(res["w0-pxq"] == answers[i]["w0-pxq"]);
+  }
+
+  // changing the graph discards the plan
+  network.connectNodes("p", "pxq", 1);
+  CPPUNIT_ASSERT(!network.getCompiled().get());
+}
+
+void TestNeuralNetworks::testParallelSubnetworks() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr sig(new SigmoidMethod);
+
+  // two subnetworks with the same labels, each one with 80 inputs, 80 hidden
+  // units and an output, 6480 connections each, enough to run in parallel
+  FeedForwardNeuralNetwork network;
+  for (int s = 0; s < 2; s++) {
+    if (s) network.allocateSubnetwork();
+    for (int i = 0; i < 80; i++) {
+      stringstream name;
+      name << "x" << i;
+      NeuralNodePtr input(new NeuralNode(name.str(), lin));
+      (*input).setType(INPUT);
+      network.addNode(input, s);
+    }
+    NeuralNodePtr output(new NeuralNode("o", sig));
+    (*output).setType(OUTPUT);
+    network.addNode(output, s);
+    for (int j = 0; j < 80; j++) {
+      stringstream name;
+      name << "h" << j;
+      NeuralNodePtr hidden(new NeuralNode(name.str(), sig));
+      (*hidden).setBias(((j % 7) - 3) / 10.0);
+      network.addNode(hidden, s);
+      for (int i = 0; i < 80; i++) {
+        stringstream source;
+        source << "x" << i;
+        network.connectNodes(source.str(), name.str(),
+                             ((s * 5 + i * 31 + j * 17) % 13 - 6) / 20.0, s, s);
+      }
+      network.connectNodes(name.str(), "o", ((j * 7 + s) % 11 - 5) / 10.0, s, s);
+    }
+  }
+  CPPUNIT_ASSERT(network.noSubNN() == 2);
+
+  vector<ParamsMap> questions, answers;
+  for (int q = 0; q < 4; q++) {
+    ParamsMap question;
+    for (int s = 0; s < 2; s++) {
+      for (int i = 0; i < 80; i++) {
+        stringstream label;
+        label << "w" << s << "-x" << i;
+        question[label.str()] = ((q + s + i) % 5) / 4.0;
+      }
+    }
+    questions.push_back(question);
+  }
+
+  CPPUNIT_ASSERT(network.compile());
+  CPPUNIT_ASSERT(network.getCompiled()->independentSubnetworks());
+  CPPUNIT_ASSERT(network.getCompiled()->noSubNN() == 2);
+  // the plan also counts the connection of each input end to its node
+  CPPUNIT_ASSERT(network.getCompiled()->noConnections() == 2 * (80 + 6480));
+  for (unsigned int q = 0; q < questions.size(); q++) {
+    answers.push_back(network.evaluate(questions[q]));
+  }
+
+  // the subnetworks compute the same values in the threads of the pool
+  network.setThreadPool(nalso::utils::ThreadPoolPtr(new nalso::utils::ThreadPool(3)));
+  for (unsigned int q = 0; q < questions.size(); q++) {
+    ParamsMap res = network.evaluate(questions[q]);
+    CPPUNIT_ASSERT(res.size() == 2);
+    CPPUNIT_ASSERT(res["w0-o"] == answers[q]["w0-o"]);
+    CPPUNIT_ASSERT(res["w1-o"] == answers[q]["w1-o"]);
+  }
+
+  // a connection across the subnetworks makes the plan a single subnetwork,
+  // evaluated in order whatever the pool
+  network.connectNodes("h0", "o", 1, 0, 1);
+  CPPUNIT_ASSERT(network.compile());
+  CPPUNIT_ASSERT(!network.getCompiled()->independentSubnetworks());
+  CPPUNIT_ASSERT(network.getCompiled()->noSubNN() == 1);
+  ParamsMap crossed = network.evaluate(questions[0]);
+  CPPUNIT_ASSERT(crossed["w0-o"] == answers[0]["w0-o"]);
+  CPPUNIT_ASSERT(crossed["w1-o"] != answers[0]["w1-o"]);
+  network.setThreadPool(nalso::utils::ThreadPoolPtr());
+  ParamsMap serial = network.evaluate(questions[0]);
+  CPPUNIT_ASSERT(crossed["w0-o"] == serial["w0-o"] && crossed["w1-o"] == serial["w1-o"]);
+}
+
+void TestNeuralNetworks::testPortEvaluation() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr sig(new SigmoidMethod);
+
+  NeuralNodePtr nnp(new NeuralNode("p", lin));
+  (*nnp).setType(INPUT);
+  NeuralNodePtr nnq(new NeuralNode("q", lin));
+  (*nnq).setType(INPUT);
+  NeuralNodePtr nnr(new NeuralNode("r", sig));
+  (*nnr).setType(OUTPUT);
+
+  FeedForwardNeuralNetwork network;
+  network.addNode(nnp);
+  network.addNode(nnq);
+  network.addNode(nnr);
+  network.connectNodes("p", "r", 2);
+  network.connectNodes("q", "r", -1);
+
+  CPPUNIT_ASSERT(network.noInputs() == 2);
+  CPPUNIT_ASSERT(network.noOutputs() == 1);
+  CPPUNIT_ASSERT(network.inputPort("w0-x") == -1);
+
+  int p = network.inputPort("w0-p");
+  int q = network.inputPort("w0-q");
+  int r = network.outputPort("w0-r");
+  CPPUNIT_ASSERT(p >= 0 && q >= 0 && r >= 0);
+
+  vector<double> in(2), out(1);
+  in[p] = 1;
+  in[q] = 0.5;
+  network.evaluate(in, out);
+
+  ParamsMap question;
+  question["w0-p"] = 1;
+  question["w0-q"] = 0.5;
+  CPPUNIT_ASSERT(network.evaluate(question)["w0-r"] == out[r]);
+
+  // the inputs given by port are kept for the labels not in the map
+  in[q] = -1;
+  network.evaluate(in, out);
+  question.erase("w0-q");
+  CPPUNIT_ASSERT(network.evaluate(question)["w0-r"] == out[r]);
+}
+
+void TestNeuralNetworks::testBatchEvaluation() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr bip(new BipolarSemilinearMethod(1));
+
+  FeedForwardNeuralNetwork network;
+  for (int i = 0; i < 3; i++) {
+    stringstream name;
+    name << "x" << i;
+    NeuralNodePtr input(new NeuralNode(name.str(), lin));
+    (*input).setType(INPUT);
+    network.addNode(input);
+  }
+  NeuralNodePtr h(new NeuralNode("h", bip));
+  (*h).setBias(-0.5);
+  network.addNode(h);
+  NeuralNodePtr out(new NeuralNode("o", lin));
+  (*out).setType(OUTPUT);
+  network.addNode(out);
+
+  network.connectNodes("x0", "h", 1);
+  network.connectNodes("x1", "h", -1);
+  network.connectNodes("x2", "h", 1);
+  network.connectNodes("h", "o", 2);
+
+  // more rows than a tile so the last tile is a partial one
+  unsigned int rows = CompiledNetwork::BATCH_TILE + 5;
+  vector<double> in(rows * 3), batch(rows), single(1);
+  for (unsigned int i = 0; i < in.size(); i++) in[i] = (i * 7) % 3 - 1.0;
+
+  network.evaluateBatch(in, batch, rows);
+  for (unsigned int r = 0; r < rows; r++) {
+    network.evaluate(span<const double>(in).subspan(r * 3, 3), single);
+    CPPUNIT_ASSERT(batch[r] == single[0]);
+  }
+}
+
+/**
+ * Builds a network with two inputs, three hidden units and one output, and a
+ * dataset with the exclusive or of the inputs.
+ */
+static void buildXorNetwork(FeedForwardNeuralNetwork& network, Dataset& data) {
+  NeuralMethodPtr sig(new SigmoidMethod);
+
+  for (int i = 0; i < 2; i++) {
+    stringstream name;
+    name << "x" << i;
+    NeuralNodePtr input(new NeuralNode(name.str(), sig));
+    (*input).setType(INPUT);
+    network.addNode(input);
+  }
+  double initial[3][3] = {{0.1, 0.4, -0.3}, {-0.2, -0.5, 0.6}, {0.3, 0.2, 0.7}};
+  for (int j = 0; j < 3; j++) {
+    stringstream name;
+    name << "h" << j;
+    NeuralNodePtr hidden(new NeuralNode(name.str(), sig));
+    (*hidden).setBias(initial[j][0]);
+    network.addNode(hidden);
+    network.connectNodes("x0", name.str(), initial[j][1]);
+    network.connectNodes("x1", name.str(), initial[j][2]);
+  }
+  NeuralNodePtr out(new NeuralNode("o", sig));
+  (*out).setType(OUTPUT);
+  (*out).setBias(-0.1);
+  network.addNode(out);
+  network.connectNodes("h0", "o", 0.5);
+  network.connectNodes("h1", "o", -0.4);
+  network.connectNodes("h2", "o", 0.3);
+
+  double examples[4][3] = {{0, 0, 0}, {0, 1, 1}, {1, 0, 1}, {1, 1, 0}};
+  for (int i = 0; i < 4; i++) {
+    data.addExample(span<const double>(examples[i], 2),
+                    span<const double>(examples[i] + 2, 1));
+  }
+}
+
+void TestNeuralNetworks::testBackpropagation() {
+  FeedForwardNeuralNetwork network;
+  Dataset data(2, 1);
+  buildXorNetwork(network, data);
+  CPPUNIT_ASSERT(data.size() == 4);
+  CPPUNIT_ASSERT(network.compile());
+
+  Trainer trainer(network.getCompiled(), 0.5, 0.9);
+  trainer.setSeed(1);
+  double before = trainer.error(data);
+  CPPUNIT_ASSERT(trainer.train(data, 5000) < before);
+  CPPUNIT_ASSERT(trainer.error(data) < 0.01);
+
+  // the trained weights are copied back into the graph
+  vector<double> trained(1), recompiled(1);
+  network.evaluate(data.input(1), trained);
+  CPPUNIT_ASSERT(network.compile());
+  network.evaluate(data.input(1), recompiled);
+  CPPUNIT_ASSERT(trained[0] == recompiled[0]);
+}
+
+void TestNeuralNetworks::testParallelTraining() {
+  FeedForwardNeuralNetwork serial, parallel;
+  Dataset data(2, 1);
+  buildXorNetwork(serial, data);
+  buildXorNetwork(parallel, data);
+  CPPUNIT_ASSERT(serial.compile());
+  CPPUNIT_ASSERT(parallel.compile());
+
+  Trainer one(serial.getCompiled(), 0.5, 0.9);
+  Trainer many(parallel.getCompiled(), 0.5, 0.9);
+  one.setBatchSize(4);
+  many.setBatchSize(4);
+  one.setSeed(1);
+  many.setSeed(1);
+  many.setThreadPool(nalso::utils::ThreadPoolPtr(new nalso::utils::ThreadPool(3)));
+
+  // the shards only change how the gradients of a batch are summed
+  double expected = one.train(data, 200);
+  CPPUNIT_ASSERT(fabs(many.train(data, 200) - expected) < 1e-9);
+
+  many.setHogwild(true);
+  CPPUNIT_ASSERT(many.train(data, 200) >= 0);
+}
+
+void TestNeuralNetworks::testOptimizers() {
+  OptimizerPtr optimizers[] = {OptimizerPtr(new RProp()),
+                               OptimizerPtr(new Adam(0.05))};
+  for (int i = 0; i < 2; i++) {
+    FeedForwardNeuralNetwork network;
+    Dataset data(2, 1);
+    buildXorNetwork(network, data);
+    CPPUNIT_ASSERT(network.compile());
+    unsigned int sections = network.getCompiled()->noSections();
+
+    Trainer trainer(network.getCompiled(), optimizers[i]);
+    // the state of the optimiser lives in the arena
+    CPPUNIT_ASSERT(network.getCompiled()->noSections() == sections + 2);
+    trainer.setBatchSize(data.size());
+    trainer.train(data, 1000);
+    CPPUNIT_ASSERT(trainer.error(data) < 0.01);
+
+    // replacing the optimiser reuses its sections instead of adding more
+    trainer.setOptimizer(OptimizerPtr(new RProp()));
+    trainer.setOptimizer(OptimizerPtr(new Adam(0.05)));
+    CPPUNIT_ASSERT(network.getCompiled()->noSections() == sections + 2);
+    trainer.setOptimizer(OptimizerPtr(new MomentumSgd()));
+    CPPUNIT_ASSERT(network.getCompiled()->noSections() == sections);
+  }
+}
+
+void TestNeuralNetworks::testEarlyStopping() {
+  FeedForwardNeuralNetwork network;
+  Dataset data(2, 1);
+  buildXorNetwork(network, data);
+  CPPUNIT_ASSERT(network.compile());
+
+  // learning the exclusive or can only make the error on its negation worse
+  Dataset validation(2, 1);
+  for (unsigned int i = 0; i < data.size(); i++) {
+    double negated = 1 - data.target(i)[0];
+    validation.addExample(data.input(i), span<const double>(&negated, 1));
+  }
+
+  TrainerPtr trainer(new Trainer(network.getCompiled(), 0.5, 0.9));
+  trainer->setSeed(1);
+  EarlyStopping stopping(trainer, 10, 3);
+  double best = stopping.train(data, validation, 5000);
+  CPPUNIT_ASSERT(stopping.getEpochs() < 5000);
+  CPPUNIT_ASSERT(stopping.getBestEpoch() < stopping.getEpochs());
+  // the weights of the best validation are the ones left in the network
+  CPPUNIT_ASSERT(trainer->error(validation) == best);
+}
+
+void TestNeuralNetworks::testActivationKernels() {
+  vector<double> sums;
+  for (int i = -5000; i <= 5000; i++) sums.push_back(i / 100.0);
+  // an odd size leaves a partial vector at the end
+  sums.push_back(0.123);
+
+  vector<double> sigmoid(sums), bipolar(sums);
+  kernels::sigmoid(sigmoid.data(), sigmoid.size(), EXACT_ACCURACY);
+  kernels::bipolar(bipolar.data(), bipolar.size(), 1.5, EXACT_ACCURACY);
+  CPPUNIT_ASSERT(sigmoid.front() == 0 && sigmoid.back() == 1 / (1 + exp(-0.123)));
+  CPPUNIT_ASSERT(bipolar.front() == -1 && bipolar[bipolar.size() - 2] == 1);
+
+  KernelIsa best = kernels::bestIsa();
+  for (int isa = SCALAR_ISA; isa <= best; isa++) {
+    CPPUNIT_ASSERT(kernels::setIsa((KernelIsa)isa));
+    vector<double> fastSigmoid(sums), fastBipolar(sums);
+    kernels::sigmoid(fastSigmoid.data(), fastSigmoid.size(), FAST_ACCURACY);
+    kernels::bipolar(fastBipolar.data(), fastBipolar.size(), 1.5, FAST_ACCURACY);
+    for (unsigned int i = 0; i < sums.size(); i++) {
+      CPPUNIT_ASSERT(fabs(fastSigmoid[i] - sigmoid[i]) < 2e-9);
+      CPPUNIT_ASSERT(fabs(fastBipolar[i] - bipolar[i]) < 4e-9);
+    }
+  }
+  CPPUNIT_ASSERT(kernels::setIsa(best));
+}
+
+void TestNeuralNetworks::testReducedPrecision() {
+  FeedForwardNeuralNetwork network;
+  Dataset data(2, 1);
+  buildXorNetwork(network, data);
+  CPPUNIT_ASSERT(network.compile());
+  CompiledNetworkPtr compiled = network.getCompiled();
+  Trainer trainer(compiled, OptimizerPtr(new RProp()));
+  trainer.setBatchSize(data.size());
+
+  vector<double> input;
+  for (unsigned int i = 0; i < data.size(); i++) {
+    input.insert(input.end(), data.input(i).begin(), data.input(i).end());
+  }
+  vector<double> exact(data.size()), reduced(data.size());
+  Precision precisions[] = {FLOAT_PRECISION, MIXED_PRECISION};
+  for (int i = 0; i < 2; i++) {
+    network.setPrecision(precisions[i]);
+    compiled->evaluateBatch(input, reduced, data.size());
+    // the single precision weights must follow the training
+    trainer.train(data, 500);
+    compiled->evaluateBatch(input, reduced, data.size());
+    for (unsigned int j = 0; j < data.size(); j++) {
+      double output;
+      compiled->evaluate(data.input(j), span<double>(&output, 1));
+      CPPUNIT_ASSERT(output == reduced[j]);
+    }
+
+    network.setPrecision(DOUBLE_PRECISION);
+    compiled->evaluateBatch(input, exact, data.size());
+    for (unsigned int j = 0; j < data.size(); j++) {
+      CPPUNIT_ASSERT(fabs(reduced[j] - exact[j]) < 1e-5);
+    }
+  }
+}
+
+void TestNeuralNetworks::testTernaryNetwork() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr bip(new BipolarSemilinearMethod(1));
+
+  // a Cilp like network for o :- p, not q and o :- r
+  FeedForwardNeuralNetwork network;
+  const char* atoms[] = {"p", "q", "r"};
+  for (int i = 0; i < 3; i++) {
+    NeuralNodePtr input(new NeuralNode(atoms[i], lin));
+    (*input).setType(INPUT);
+    network.addNode(input);
+  }
+  NeuralNodePtr h0(new NeuralNode("h0", bip));
+  (*h0).setBias(-2);
+  network.addNode(h0);
+  NeuralNodePtr h1(new NeuralNode("h1", bip));
+  network.addNode(h1);
+  NeuralNodePtr out(new NeuralNode("o", bip));
+  (*out).setType(OUTPUT);
+  (*out).setBias(2);
+  network.addNode(out);
+
+  network.connectNodes("p", "h0", 2);
+  network.connectNodes("q", "h0", -2);
+  network.connectNodes("r", "h1", 2);
+  network.connectNodes("h0", "o", 2);
+  network.connectNodes("h1", "o", 2);
+  CPPUNIT_ASSERT(network.compile());
+
+  TernaryNetworkPtr ternary = TernaryNetwork::compile(network.getCompiled());
+  CPPUNIT_ASSERT(ternary.get());
+  CPPUNIT_ASSERT(ternary->noInputWords() == 1);
+
+  vector<double> in(3), truth(1), value(1);
+  for (int a = 0; a < 8; a++) {
+    for (int i = 0; i < 3; i++) in[i] = (a >> i) & 1 ? 1 : -1;
+    CPPUNIT_ASSERT(ternary->query(in, truth));
+    bool expected = (in[0] == 1 && in[1] == -1) || in[2] == 1;
+    CPPUNIT_ASSERT(truth[0] == (expected ? 1 : -1));
+    // the values of the compiled network agree with the truth values
+    network.getCompiled()->evaluate(in, value);
+    CPPUNIT_ASSERT((value[0] > 0) == expected);
+  }
+
+  // the batch packs 64 assignments per word and agrees with evaluate, also
+  // in the last partial word
+  unsigned int rows = 70;
+  vector<uint64_t> truths(rows), batch(rows), active(1);
+  for (unsigned int r = 0; r < rows; r++) truths[r] = r % 8;
+  ternary->evaluateBatch(truths, batch, rows);
+  for (unsigned int r = 0; r < rows; r++) {
+    ternary->evaluate(&truths[r], active.data());
+    CPPUNIT_ASSERT(batch[r] == active[0]);
+  }
+
+  // inputs which are not truth values are evaluated by the compiled network
+  in[0] = 0.5;
+  CPPUNIT_ASSERT(!ternary->query(in, truth));
+  network.getCompiled()->evaluate(in, value);
+  CPPUNIT_ASSERT(truth[0] == (value[0] > 0 ? 1 : -1));
+
+  // weights of different magnitudes can not be counted
+  network.connectNodes("p", "h1", 1);
+  CPPUNIT_ASSERT(network.compile());
+  CPPUNIT_ASSERT(!TernaryNetwork::compile(network.getCompiled()).get());
+}
+
+void TestNeuralNetworks::testCilp() {
+  using namespace nalso::logic;
+  map<string, BoolVarPtr> atoms;
+  const char* names[] = {"a", "b", "c", "d", "x", "y", "z", "u"};
+  for (int i = 0; i < 8; i++) atoms[names[i]].reset(new BoolVar(names[i]));
+  // builds head :- body, where a body atom starting with ~ is negated
+  auto clause = [&](const char* head, vector<string> body) {
+    ClausePtr cl(new Clause);
+    cl->setHead(atoms[head]);
+    for (unsigned int i = 0; i < body.size(); i++) {
+      bool negated = body[i][0] == '~';
+      cl->addToBody(LiteralPtr(new Literal(atoms[body[i].substr(negated)], negated)));
+    }
+    return cl;
+  };
+
+  // a :- b, not c. a :- d. b.
+  set<ClausePtr> first = {clause("a", {"b", "~c"}), clause("a", {"d"}), clause("b", {})};
+  // x :- y, z, u. x :- not y.
+  set<ClausePtr> second = {clause("x", {"y", "z", "u"}), clause("x", {"~y"})};
+
+  // the largest body or number of clauses of a head is 2 and then 3
+  double amins[] = {1.0 / 3, 0.5};
+  nalso::algorithms::Cilp cilp(1);
+  for (int p = 0; p < 2; p++) {
+    // the same builder computes the parameters of every program again
+    NeuralNetworkPtr network = cilp.buildNetwork(p ? second : first);
+    for (int v = 0; v < 16; v++) {
+      ParamsMap input;
+      bool in[3];
+      for (int i = 0; i < 3; i++) in[i] = (v >> i) & 1;
+      input[p ? "w0-y" : "w0-b"] = in[0] ? 1 : -1;
+      input[p ? "w0-z" : "w0-c"] = in[1] ? 1 : -1;
+      input[p ? "w0-u" : "w0-d"] = in[2] ? 1 : -1;
+      input[p ? "w0-x" : "w0-a"] = (v >> 3) & 1 ? 1 : -1;
+      ParamsMap output = network->evaluate(input);
+
+      // every output is a bipolar truth value beyond amin
+      map<string, bool> expected;
+      if (p) {
+        expected["w0-x"] = (in[0] && in[1] && in[2]) || !in[0];
+        expected["w0-y"] = expected["w0-z"] = expected["w0-u"] = false;
+      } else {
+        // the hidden units of both clauses reach the output of a, the bias of
+        // b makes the fact true and heads without clauses stay false
+        expected["w0-a"] = (in[0] && !in[1]) || in[2];
+        expected["w0-b"] = true;
+        expected["w0-c"] = expected["w0-d"] = false;
+      }
+      CPPUNIT_ASSERT(output.size() == expected.size());
+      for (auto it = expected.begin(); it != expected.end(); it++) {
+        double value = output[(*it).first];
+        CPPUNIT_ASSERT(fabs(value) <= 1);
+        CPPUNIT_ASSERT((*it).second ? value > amins[p] : value < -amins[p]);
+      }
+    }
+  }
+
+  // an amin given by the caller is used for every program
+  nalso::algorithms::Cilp strict(1, 0.9);
+  NeuralNetworkPtr network = strict.buildNetwork(first);
+  ParamsMap input = {{"w0-a", -1}, {"w0-b", 1}, {"w0-c", -1}, {"w0-d", -1}};
+  ParamsMap output = network->evaluate(input);
+  CPPUNIT_ASSERT(output["w0-a"] > 0.9 && output["w0-b"] > 0.9);
+  CPPUNIT_ASSERT(output["w0-c"] < -0.9 && output["w0-d"] < -0.9);
+}
+
+void TestNeuralNetworks::testSlicedNetwork() {
+  NeuralMethodPtr lin(new LinearMethod);
+  NeuralMethodPtr step(new StepMethod);
+
+  // xor of a and b with an extra input c added with a larger weight
+  FeedForwardNeuralNetwork network;
+  const char* names[] = {"a", "b", "c"};
+  for (int i = 0; i < 3; i++) {
+    NeuralNodePtr input(new NeuralNode(names[i], lin));
+    (*input).setType(INPUT);
+    network.addNode(input);
+  }
+  NeuralNodePtr any(new NeuralNode("any", step));
+  (*any).setBias(0.75);
+  network.addNode(any);
+  NeuralNodePtr both(new NeuralNode("both", step));
+  (*both).setBias(1.5);
+  network.addNode(both);
+  NeuralNodePtr out(new NeuralNode("o", step));
+  (*out).setType(OUTPUT);
+  (*out).setBias(1.5);
+  network.addNode(out);
+
+  network.connectNodes("a", "any", 0.75);
+  network.connectNodes("b", "any", 0.75);
+  network.connectNodes("a", "both", 0.75);
+  network.connectNodes("b", "both", 0.75);
+  network.connectNodes("any", "o", 1.5);
+  network.connectNodes("both", "o", -2.25);
+  network.connectNodes("c", "o", 2.25);
+  CPPUNIT_ASSERT(network.compile());
+
+  SlicedNetworkPtr sliced = SlicedNetwork::compile(network.getCompiled());
+  CPPUNIT_ASSERT(sliced.get());
+
+  // one word per plane, lane l holds the digits of l
+  vector<uint64_t> planes(3), result(1);
+  sliced->enumerate(planes, 0, 1);
+  sliced->evaluate(planes, result, 1);
+
+  vector<double> in(3), value(1);
+  for (int l = 0; l < 64; l++) {
+    for (int i = 0; i < 3; i++) in[i] = (l >> i) & 1;
+    network.getCompiled()->evaluate(in, value);
+    CPPUNIT_ASSERT(value[0] == (double)((result[0] >> l) & 1));
+  }
+  CPPUNIT_ASSERT(((result[0] >> 1) & 1) == 1);
+  CPPUNIT_ASSERT(((result[0] >> 3) & 1) == 0);
+  CPPUNIT_ASSERT(((result[0] >> 7) & 1) == 1);
+
+  // the sum of a sigmoid node is not a count
+  NeuralNodePtr sig(new NeuralNode("s", NeuralMethodPtr(new SigmoidMethod)));
+  network.addNode(sig);
+  network.connectNodes("s", "o", 1);
+  network.connectNodes("a", "s", 1);
+  CPPUNIT_ASSERT(network.compile());
+  CPPUNIT_ASSERT(!SlicedNetwork::compile(network.getCompiled()).get());
+}
+
+void TestNeuralNetworks::testTruthTableSweeper() {
+  FeedForwardNeuralNetwork network;
+  Dataset data(2, 1);
+  buildXorNetwork(network, data);
+  CPPUNIT_ASSERT(network.compile());
+
+  TruthTableSweeperPtr sweeper = TruthTableSweeper::compile(network.getCompiled());
+  CPPUNIT_ASSERT(sweeper.get());
+  CPPUNIT_ASSERT(sweeper->noRows() == 4);
+
+  // every row is visited once and agrees with the compiled network
+  vector<double> table(4, -1);
+  sweeper->sweep([&](uint64_t assignment, span<const double> output) {
+    CPPUNIT_ASSERT(table[assignment] == -1);
+    table[assignment] = output[0];
+  });
+  vector<double> in(2), value(1);
+  for (int a = 0; a < 4; a++) {
+    for (int i = 0; i < 2; i++) in[i] = (a >> i) & 1;
+    network.getCompiled()->evaluate(in, value);
+    CPPUNIT_ASSERT(fabs(table[a] - value[0]) < 1e-12);
+  }
+
+  // the ranges of the Gray code are merged in order
+  sweeper->setThreadPool(nalso::utils::ThreadPoolPtr(new nalso::utils::ThreadPool(2)));
+  double middle = (table[0] + table[3]) / 2;
+  vector<uint64_t> high = sweeper->select(
+      [&](uint64_t assignment, span<const double> output) { return output[0] > middle; });
+  vector<uint64_t> expected;
+  for (int a = 0; a < 4; a++) {
+    if (table[a] > middle) expected.push_back(a);
+  }
+  CPPUNIT_ASSERT(high == expected);
+}
+
+void TestNeuralNetworks::testIncrementalNetwork() {
+  FeedForwardNeuralNetwork network;
+  Dataset data(2, 1);
+  buildXorNetwork(network, data);
+  CPPUNIT_ASSERT(network.compile());
+
+  IncrementalNetworkPtr incremental = IncrementalNetwork::compile(network.getCompiled());
+  CPPUNIT_ASSERT(incremental.get());
+
+  // the first call computes the six nodes, input nodes included
+  vector<double> delta(1), value(1);
+  incremental->evaluate(data.input(0), delta);
+  CPPUNIT_ASSERT(incremental->noUpdated() == 6);
+
+  // the same inputs touch nothing
+  incremental->evaluate(data.input(0), delta);
+  CPPUNIT_ASSERT(incremental->noUpdated() == 0);
+
+  // changing one input leaves the node of the other one alone
+  int rows[] = {1, 3, 2, 0, 3};
+  for (int r = 0; r < 5; r++) {
+    incremental->evaluate(data.input(rows[r]), delta);
+    network.getCompiled()->evaluate(data.input(rows[r]), value);
+    CPPUNIT_ASSERT(fabs(delta[0] - value[0]) < 1e-12);
+    CPPUNIT_ASSERT(incremental->noUpdated() == (r < 4 ? 5 : 6));
+  }
+}
 
 void TestNeuralNetworks::testHopfield() {
   HopfieldNeuralNetwork network;
@@ -682,6 +1504,208 @@ void TestNeuralNetworks::testFixPointHopfield6() {
     cout << (*it).first << ": " << (*it).second << endl;
 }
 
+/**
+ * Adds the nodes n00 to n11 to a Hopfield network and 30 hyperedges over them,
+ * of orders 1 to maxOrder and with weights from -5 to 5.
+ *
+ * @param nodeset Filled with the nodes added, in id order.
+ *
+ * @param repeat Whether every ninth hyperedge holds its first node twice.
+ *
+ * @return the numbers of the nodes of each hyperedge.
+ */
+static vector<vector<int> > buildHyperedges(HopfieldNeuralNetwork& network,
+                                            vector<HopfieldNodePtr>& nodeset,
+                                            int maxOrder, bool repeat) {
+  nodeset.clear();
+  for (int i = 0; i < 12; i++) {
+    stringstream name;
+    name << "n" << (i < 10 ? "0" : "") << i;
+    nodeset.push_back(HopfieldNodePtr(new HopfieldNode(name.str())));
+    network.addNode(nodeset.back());
+  }
+
+  vector<vector<int> > links;
+  for (int e = 0; e < 30; e++) {
+    vector<HopfieldNodePtr> link;
+    links.push_back(vector<int>());
+    for (int k = 0; k <= e % maxOrder; k++) {
+      links.back().push_back((e * 7 + k * 5) % 12);
+      link.push_back(nodeset[links.back().back()]);
+    }
+    if (repeat && e % 9 == 0) {
+      links.back().push_back(links.back().front());
+      link.push_back(link.front());
+    }
+    network.connectNodes(link, (e % 2 ? -1 : 1) * (1 + e % 5));
+  }
+  return links;
+}
+
+void TestNeuralNetworks::testCompiledHopfield() {
+  // the same hyperedges on two networks, one iterated through the compiled
+  // network and the other one node by node, with orders from 1 to 6 and a
+  // node repeated now and then
+  HopfieldNeuralNetwork compiled(0.5), manual(0.5);
+  vector<HopfieldNodePtr> nodeset, copies;
+  buildHyperedges(manual, nodeset, 6, true);
+  buildHyperedges(compiled, copies, 6, true);
+
+  ParamsMap question;
+  for (int i = 0; i < 12; i++) question[nodeset[i]->getId()] = (i % 3) - 1;
+  FixPointResult result;
+  ParamsMap answer = compiled.findFixPoint(question, 0, FixPointBudget(5, 0, 0), &result);
+  CPPUNIT_ASSERT(compiled.getCompiled().get());
+  CPPUNIT_ASSERT(compiled.getCompiled()->noNodes() == 12);
+  CPPUNIT_ASSERT(compiled.getCompiled()->noEdges() == 30);
+  CPPUNIT_ASSERT(result.status == EXHAUSTED_STATUS);
+  CPPUNIT_ASSERT(result.iterations == 5);
+
+  manual.evaluate(question);
+  for (int s = 0; s < 5; s++) {
+    for (int i = 0; i < 12; i++) nodeset[i]->computeNextPotential();
+    for (int i = 0; i < 12; i++) nodeset[i]->updatePotential();
+  }
+  // the products are associated differently
+  for (int i = 0; i < 12; i++) {
+    CPPUNIT_ASSERT(fabs(answer[nodeset[i]->getId()] - nodeset[i]->outputValue()) < 1e-12);
+  }
+
+  // the outputs of the sigmoid kernel are within its error
+  compiled.setAccuracy(FAST_ACCURACY);
+  ParamsMap fast = compiled.findFixPoint(question, 0, FixPointBudget(5, 0, 0));
+  for (int i = 0; i < 12; i++) {
+    CPPUNIT_ASSERT(fabs(fast[nodeset[i]->getId()] - answer[nodeset[i]->getId()]) < 1e-6);
+  }
+  compiled.setAccuracy(EXACT_ACCURACY);
+
+  // the products in single precision stay close to those in double, in both
+  // update modes
+  Precision precisions[] = {FLOAT_PRECISION, MIXED_PRECISION};
+  UpdateMode modes[] = {SYNCHRONOUS_UPDATE, ASYNCHRONOUS_UPDATE};
+  for (int m = 0; m < 2; m++) {
+    compiled.setUpdateMode(modes[m]);
+    compiled.setPrecision(DOUBLE_PRECISION);
+    ParamsMap exact = compiled.findFixPoint(question, 0, FixPointBudget(5, 0, 0));
+    for (int p = 0; p < 2; p++) {
+      compiled.setPrecision(precisions[p]);
+      ParamsMap reduced = compiled.findFixPoint(question, 0, FixPointBudget(5, 0, 0));
+      for (int i = 0; i < 12; i++) {
+        CPPUNIT_ASSERT(fabs(reduced[nodeset[i]->getId()] - exact[nodeset[i]->getId()]) < 1e-4);
+      }
+    }
+  }
+  compiled.setPrecision(DOUBLE_PRECISION);
+  compiled.setUpdateMode(SYNCHRONOUS_UPDATE);
+
+  // an output of 0 only cancels the terms of the other members
+  HopfieldNeuralNetwork zero;
+  const char* names[] = {"a", "b", "c"};
+  vector<HopfieldNodePtr> abc;
+  for (int i = 0; i < 3; i++) {
+    abc.push_back(HopfieldNodePtr(new HopfieldNode(names[i])));
+    zero.addNode(abc.back());
+  }
+  zero.connectNodes(abc, 4);
+  question.clear();
+  question["a"] = -1e6;
+  question["b"] = 0;
+  question["c"] = 0;
+  zero.findFixPoint(question, 0, FixPointBudget(1, 0, 0));
+  CPPUNIT_ASSERT(abc[0]->getPotential() == -1e6 + 1);
+  CPPUNIT_ASSERT(abc[1]->getPotential() == 0);
+  CPPUNIT_ASSERT(abc[2]->getPotential() == 0);
+
+  // a hyperedge with a node from outside the network can not be compiled
+  CPPUNIT_ASSERT(manual.compile());
+  HopfieldNodePtr stranger(new HopfieldNode("stranger"));
+  vector<HopfieldNodePtr> link;
+  link.push_back(nodeset[0]);
+  link.push_back(stranger);
+  manual.connectNodes(link, 1);
+  CPPUNIT_ASSERT(!manual.getCompiled().get());
+  CPPUNIT_ASSERT(!manual.compile());
+}
+
+void TestNeuralNetworks::testParallelHopfield() {
+  // enough nodes and slots for several blocks of each
+  HopfieldNeuralNetwork single(20), many(20);
+  vector<HopfieldNodePtr> singleNodes, manyNodes;
+  for (int i = 0; i < 5000; i++) {
+    stringstream name;
+    name << "n" << i;
+    singleNodes.push_back(HopfieldNodePtr(new HopfieldNode(name.str())));
+    single.addNode(singleNodes.back());
+    manyNodes.push_back(HopfieldNodePtr(new HopfieldNode(name.str())));
+    many.addNode(manyNodes.back());
+  }
+  for (int e = 0; e < 8000; e++) {
+    vector<HopfieldNodePtr> singleLink, manyLink;
+    for (int k = 0; k <= e % 7; k++) {
+      int node = (e * 37 + k * 1013) % 5000;
+      singleLink.push_back(singleNodes[node]);
+      manyLink.push_back(manyNodes[node]);
+    }
+    double weight = ((e * 13) % 21 - 10) / 10.0;
+    single.connectNodes(singleLink, weight);
+    many.connectNodes(manyLink, weight);
+  }
+  many.setThreadPool(nalso::utils::ThreadPoolPtr(new nalso::utils::ThreadPool(3)));
+
+  ParamsMap question;
+  for (int i = 0; i < 5000; i++) question[singleNodes[i]->getId()] = (i % 7) - 3;
+  FixPointResult singleResult, manyResult;
+  ParamsMap singleAnswer = single.findFixPoint(question, 1e-9, FixPointBudget(50), &singleResult);
+  ParamsMap manyAnswer = many.findFixPoint(question, 1e-9, FixPointBudget(50), &manyResult);
+
+  // every value is computed as in a single thread
+  CPPUNIT_ASSERT(singleResult.status == manyResult.status);
+  CPPUNIT_ASSERT(singleResult.iterations == manyResult.iterations);
+  for (ParamsMap::iterator it = singleAnswer.begin(); it != singleAnswer.end(); it++) {
+    CPPUNIT_ASSERT((*it).second == manyAnswer[(*it).first]);
+  }
+  for (int i = 0; i < 5000; i++) {
+    CPPUNIT_ASSERT(singleNodes[i]->getPotential() == manyNodes[i]->getPotential());
+  }
+}
+
+void TestNeuralNetworks::testChromaticHopfield() {
+  HopfieldNeuralNetwork network;
+  vector<HopfieldNodePtr> nodeset;
+  vector<vector<int> > links = buildHyperedges(network, nodeset, 4, false);
+  CPPUNIT_ASSERT(network.compile());
+
+  // no two nodes of a hyperedge share a colour
+  CompiledHopfieldPtr compiled = network.getCompiled();
+  CPPUNIT_ASSERT(compiled->noColours() > 1);
+  for (unsigned int e = 0; e < links.size(); e++) {
+    for (unsigned int i = 0; i < links[e].size(); i++) {
+      CPPUNIT_ASSERT(compiled->getColour(links[e][i]) < compiled->noColours());
+      for (unsigned int j = 0; j < i; j++) {
+        CPPUNIT_ASSERT(compiled->getColour(links[e][i]) != compiled->getColour(links[e][j]));
+      }
+    }
+  }
+
+  ParamsMap question;
+  for (int i = 0; i < 12; i++) question[nodeset[i]->getId()] = (i % 3) - 1;
+  FixPointResult synchronous, asynchronous;
+  network.findFixPoint(question, 1e-9, FixPointBudget(), &synchronous);
+  network.setUpdateMode(ASYNCHRONOUS_UPDATE);
+  ParamsMap seidel = network.findFixPoint(question, 1e-9, FixPointBudget(), &asynchronous);
+  CPPUNIT_ASSERT(synchronous.status == CONVERGED_STATUS);
+  CPPUNIT_ASSERT(asynchronous.status == CONVERGED_STATUS);
+  // each colour already sees the colours updated before it
+  CPPUNIT_ASSERT(asynchronous.iterations < synchronous.iterations);
+
+  // the colours are updated in parallel with the same values
+  network.setThreadPool(nalso::utils::ThreadPoolPtr(new nalso::utils::ThreadPool(3)));
+  ParamsMap parallel = network.findFixPoint(question, 1e-9);
+  for (ParamsMap::iterator it = seidel.begin(); it != seidel.end(); it++) {
+    CPPUNIT_ASSERT((*it).second == parallel[(*it).first]);
+  }
+}
+
 CppUnit::TestSuite* TestNeuralNetworks::suite() {
   CppUnit::TestSuite* suiteOfTests =
       new CppUnit::TestSuite("TestNeuralNetworks");
@@ -691,6 +1715,41 @@ CppUnit::TestSuite* TestNeuralNetworks::suite() {
   suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
       "testFixPointOperatorFeedForward",
       &TestNeuralNetworks::testFixPointOperatorFeedForward));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testFixPointBudget", &TestNeuralNetworks::testFixPointBudget));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testAsynchronousFixPoint", &TestNeuralNetworks::testAsynchronousFixPoint));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testCompiledFeedForward",
+      &TestNeuralNetworks::testCompiledFeedForward));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testParallelSubnetworks", &TestNeuralNetworks::testParallelSubnetworks));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testPortEvaluation", &TestNeuralNetworks::testPortEvaluation));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testBatchEvaluation", &TestNeuralNetworks::testBatchEvaluation));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testBackpropagation", &TestNeuralNetworks::testBackpropagation));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testParallelTraining", &TestNeuralNetworks::testParallelTraining));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testOptimizers", &TestNeuralNetworks::testOptimizers));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testEarlyStopping", &TestNeuralNetworks::testEarlyStopping));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testActivationKernels", &TestNeuralNetworks::testActivationKernels));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testReducedPrecision", &TestNeuralNetworks::testReducedPrecision));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testTernaryNetwork", &TestNeuralNetworks::testTernaryNetwork));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testCilp", &TestNeuralNetworks::testCilp));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testSlicedNetwork", &TestNeuralNetworks::testSlicedNetwork));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testTruthTableSweeper", &TestNeuralNetworks::testTruthTableSweeper));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testIncrementalNetwork", &TestNeuralNetworks::testIncrementalNetwork));
   // suiteOfTests->addTest(new
   // CppUnit::TestCaller<TestNeuralNetworks>("testHopfield",
   // &TestNeuralNetworks::testHopfield));
@@ -707,6 +1766,12 @@ CppUnit::TestSuite* TestNeuralNetworks::suite() {
       "testFixPointHopfield5", &TestNeuralNetworks::testFixPointHopfield5));
   suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
       "testFixPointHopfield6", &TestNeuralNetworks::testFixPointHopfield6));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testCompiledHopfield", &TestNeuralNetworks::testCompiledHopfield));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testParallelHopfield", &TestNeuralNetworks::testParallelHopfield));
+  suiteOfTests->addTest(new CppUnit::TestCaller<TestNeuralNetworks>(
+      "testChromaticHopfield", &TestNeuralNetworks::testChromaticHopfield));
   return suiteOfTests;
 }
 
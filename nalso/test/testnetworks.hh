@@ -11,14 +11,27 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/TestSuite.h>
 
+#include <cmath>
 #include <fstream>
 #include <map>
+#include <span>
+#include <sstream>
 #include <vector>
 
+#include "algorithms/cilp.hh"
+#include "networks/compiledhopfield.hh"
 #include "networks/feedforward.hh"
+#include "networks/fixpoint.hh"
 #include "networks/hopfield.hh"
+#include "networks/incremental.hh"
+#include "networks/kernels.hh"
 #include "networks/method.hh"
 #include "networks/node.hh"
+#include "networks/recurrent.hh"
+#include "networks/sliced.hh"
+#include "networks/sweeper.hh"
+#include "networks/ternary.hh"
+#include "networks/trainer.hh"
 
 namespace test {
 using namespace std;
@@ -31,6 +44,23 @@ class TestNeuralNetworks : public CppUnit::TestFixture {
 
   void testFeedForwardNeuralNetwork();
   void testFixPointOperatorFeedForward();
+  void testFixPointBudget();
+  void testAsynchronousFixPoint();
+  void testCompiledFeedForward();
+  void testParallelSubnetworks();
+  void testPortEvaluation();
+  void testBatchEvaluation();
+  void testBackpropagation();
+  void testParallelTraining();
+  void testOptimizers();
+  void testEarlyStopping();
+  void testActivationKernels();
+  void testReducedPrecision();
+  void testTernaryNetwork();
+  void testCilp();
+  void testSlicedNetwork();
+  void testTruthTableSweeper();
+  void testIncrementalNetwork();
 
   void testHopfield();
   void testFixPointHopfield();
@@ -39,6 +69,9 @@ class TestNeuralNetworks : public CppUnit::TestFixture {
   void testFixPointHopfield4();
   void testFixPointHopfield5();
   void testFixPointHopfield6();
+  void testCompiledHopfield();
+  void testParallelHopfield();
+  void testChromaticHopfield();
 
   static CppUnit::TestSuite* suite();
 };
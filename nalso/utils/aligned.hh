@@ -0,0 +1,59 @@
+#pragma once
+/**
+ * @file aligned.hh
+ *
+ * @brief Allocator for cache line aligned buffers.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace nalso {
+namespace utils {
+
+/**
+ * @brief An allocator whose blocks start at a multiple of Alignment bytes.
+ *
+ * Used with std::vector for buffers read by SIMD code or written by different
+ * threads, so they start at a cache line boundary.
+ */
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef AlignedAllocator<U, Alignment> other;
+  };
+
+  AlignedAllocator() {}
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+  void deallocate(T* p, std::size_t) {
+    ::operator delete(p, std::align_val_t(Alignment));
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment>&) const {
+    return false;
+  }
+};
+
+/** A std::vector whose data starts at a cache line boundary */
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T> >;
+
+}  // namespace utils
+}  // namespace nalso
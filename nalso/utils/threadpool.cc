@@ -0,0 +1,90 @@
+/**
+ * @file threadpool.cc
+ *
+ * @date Oct 16, 2026
+ */
+#include "threadpool.hh"
+
+#include <algorithm>
+
+namespace nalso {
+namespace utils {
+
+namespace {
+/** The pool the current thread is running iterations for, if any. */
+thread_local ThreadPool* currentPool = NULL;
+}  // namespace
+
+ThreadPool::ThreadPool(unsigned int threads /*= 0*/)
+    : task(NULL), count(0), next(0), active(0), generation(0), stopping(false) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (unsigned int i = 1; i < threads; i++) {
+    workers.push_back(std::thread(&ThreadPool::work, this));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (unsigned int i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+}
+
+void ThreadPool::work() {
+  currentPool = this;
+  unsigned long seen = 0;
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.wait(lock, [&] { return stopping || generation != seen; });
+    if (stopping) return;
+    seen = generation;
+    lock.unlock();
+
+    runTasks();
+
+    lock.lock();
+    if (--active == 0) finished.notify_all();
+  }
+}
+
+void ThreadPool::runTasks() {
+  for (unsigned int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+    (*task)(i);
+  }
+}
+
+void ThreadPool::parallelFor(unsigned int count_,
+                             const std::function<void(unsigned int)>& task_) {
+  if (workers.empty() || count_ < 2 || currentPool == this) {
+    for (unsigned int i = 0; i < count_; i++) task_(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> call(callMutex);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &task_;
+    count = count_;
+    next = 0;
+    active = workers.size();
+    generation++;
+  }
+  wake.notify_all();
+
+  ThreadPool* previous = currentPool;
+  currentPool = this;
+  runTasks();
+  currentPool = previous;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  finished.wait(lock, [&] { return active == 0; });
+}
+
+}  // namespace utils
+}  // namespace nalso
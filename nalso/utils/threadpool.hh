@@ -0,0 +1,83 @@
+#pragma once
+/**
+ * @file threadpool.hh
+ *
+ * @brief A minimal fixed size thread pool.
+ *
+ * @date Oct 16, 2026
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nalso {
+namespace utils {
+
+/**
+ * @brief A fixed set of worker threads running data parallel loops.
+ *
+ * The pool only knows how to run one kind of job: a loop whose iterations are
+ * independent of each other. The iterations are distributed dynamically among
+ * the workers and the calling thread, and the call returns once all of them
+ * are done, so every call acts as a barrier.
+ *
+ * Calls to parallelFor made from inside an iteration run serially in the
+ * calling thread instead of waiting for a busy pool.
+ */
+class ThreadPool {
+ private:
+  std::vector<std::thread> workers;
+
+  std::mutex mutex, callMutex;
+  std::condition_variable wake, finished;
+
+  const std::function<void(unsigned int)>* task;
+  unsigned int count;
+  std::atomic<unsigned int> next;
+  unsigned int active;
+  unsigned long generation;
+  bool stopping;
+
+  void work();
+  void runTasks();
+
+ public:
+  /**
+   * Creates a pool with the given number of threads, counting the thread that
+   * calls parallelFor, which also takes iterations.
+   *
+   * @param threads The total number of threads working on each loop. If zero,
+   * the number of hardware threads is used.
+   */
+  ThreadPool(unsigned int threads = 0);
+  ~ThreadPool();
+
+  /**
+   * Returns the number of threads working on each loop, including the calling
+   * one.
+   *
+   * @return the number of threads of the pool plus one.
+   */
+  unsigned int size() { return workers.size() + 1; }
+
+  /**
+   * Calls task(i) for every i in [0, count) distributing the calls among the
+   * threads of the pool, and waits until all of them returned.
+   *
+   * @param count The number of iterations.
+   *
+   * @param task The body of the loop. It receives the iteration index.
+   */
+  void parallelFor(unsigned int count,
+                   const std::function<void(unsigned int)>& task);
+};
+
+typedef std::shared_ptr<ThreadPool> ThreadPoolPtr;
+
+}  // namespace utils
+}  // namespace nalso